@@ -0,0 +1,329 @@
+
+#include "RemappingCore.hpp"
+#include "StandInTypes.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using FRebindSettings = RemappingCore::TRebindSettings<FStandInTraits>;
+using FDefaults = FRebindSettings::FDefaults;
+
+using FPack = FRebindSettings::FPack;
+
+constexpr int32_t MappingsPerContext = 50;
+constexpr int32_t KeyCount = 200;
+
+// Two game sessions of the same project:
+// in the first one the player remaps every 10th key, then the project is changed before the second one.
+// Every 20th mapping gets another name (so its pack turns obsolete), every context gets 5% of new mappings
+std::shared_ptr<const FDefaults> CollectDefaults(const std::vector<FStandInContext*>& Contexts)
+{
+    const std::shared_ptr<FDefaults> Defaults = std::make_shared<FDefaults>();
+    Defaults->Collect(Contexts);
+    return Defaults;
+}
+
+class FSessionScenario
+{
+public:
+
+    explicit FSessionScenario(const int32_t MappingCount)
+    {
+        const int32_t ContextCount = (MappingCount + MappingsPerContext - 1) / MappingsPerContext;
+
+        // Reserved once, so pointers to actions and contexts stay valid between the sessions
+        Actions.reserve(static_cast<size_t>(MappingCount) * 2);
+        Contexts.reserve(ContextCount);
+
+        for (int32_t Index = 0; Index < MappingCount; ++Index)
+        {
+            if (Index % MappingsPerContext == 0)
+            {
+                const std::string Name = "IMC_Context_" + std::to_string(Contexts.size());
+                Contexts.emplace_back().Path = "/Game/Input/Contexts/" + Name + "." + Name;
+            }
+            Contexts.back().Mappings.emplace_back(MakeMapping(Index));
+        }
+
+        for (FStandInContext& Context : Contexts)
+        {
+            ContextPointers.emplace_back(&Context);
+        }
+
+        // The first session
+        const std::shared_ptr<const FDefaults> FirstDefaults = CollectDefaults(ContextPointers);
+        FRebindSettings FirstSettings;
+        FirstSettings.RecalculatePlayerMappingSettings(*FirstDefaults, std::vector<FPack>{});
+        for (size_t Index = 0; Index < FirstDefaults->Entries.size(); Index += 10)
+        {
+            FPack Pack = FirstSettings.MakePack(static_cast<int32_t>(Index));
+            FirstSettings.RemapControlKey(Pack, MakeKey(Pack.CustomKey.Id + 1));
+        }
+        StoredPacks = FirstSettings.GetStoredPacks();
+
+        // The project changes before the second session
+        int32_t NewMappingIndex = MappingCount;
+        for (FStandInContext& Context : Contexts)
+        {
+            for (size_t Index = 0; Index < Context.Mappings.size(); ++Index)
+            {
+                FStandInMapping& Mapping = Context.Mappings[Index];
+                if (Index % 20 == 19) Mapping.MappingName = FStandInName::Make(Mapping.MappingName.ToString() + "_Renamed");
+            }
+
+            const size_t NewMappingCount = std::max<size_t>(1, Context.Mappings.size() / 20);
+            for (size_t Index = 0; Index < NewMappingCount; ++Index)
+            {
+                Context.Mappings.emplace_back(MakeMapping(NewMappingIndex++));
+            }
+        }
+    }
+
+    const std::vector<FStandInContext*>& GetContexts() const { return ContextPointers; }
+    const std::vector<FPack>& GetStoredPacks() const { return StoredPacks; }
+
+private:
+
+    static FStandInKey MakeKey(const int32_t Seed)
+    {
+        const int32_t Id = Seed % KeyCount;
+        const EStandInKeyKind Kind = Id % 10 < 7 ? EStandInKeyKind::Keyboard : (Id % 10 < 8 ? EStandInKeyKind::Mouse : EStandInKeyKind::Gamepad);
+        return {Id, Kind};
+    }
+
+    FStandInMapping MakeMapping(const int32_t Index)
+    {
+        const FStandInAction& Action = Actions.emplace_back(FStandInAction{Index});
+
+        FStandInMapping Mapping;
+        Mapping.Action = &Action;
+        Mapping.Key = MakeKey(Index);
+        // Most of mappings are mappable, some are not
+        Mapping.bIsPlayerMappable = Index % 5 != 4;
+        Mapping.MappingName = FStandInName::Make("IA_Action_" + std::to_string(Index));
+        if (Index % 3 == 0) Mapping.CustomDisplayName = "Custom display name " + std::to_string(Index);
+        return Mapping;
+    }
+
+    std::vector<FStandInAction> Actions;
+    std::vector<FStandInContext> Contexts;
+    std::vector<FStandInContext*> ContextPointers;
+    std::vector<FPack> StoredPacks;
+};
+
+void ApplyMappingCounts(benchmark::internal::Benchmark* Benchmark)
+{
+    for (const int MappingCount : {100, 1000, 10000, 50000})
+    {
+        Benchmark->Arg(MappingCount);
+    }
+    Benchmark->Unit(benchmark::kMillisecond);
+}
+
+} // namespace
+
+
+//////////////////////////////////////////
+
+
+// Session start of a new player, who has no stored settings
+static void BM_FirstSessionStart(benchmark::State& State)
+{
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    size_t PackCount = 0;
+    for (auto _ : State)
+    {
+        State.PauseTiming();
+        FRebindSettings Settings;
+        State.ResumeTiming();
+
+        const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+        Settings.RecalculatePlayerMappingSettings(*Defaults, std::vector<FPack>{});
+        PackCount = Defaults->Entries.size();
+    }
+    State.counters["Packs"] = static_cast<double>(PackCount);
+}
+BENCHMARK(BM_FirstSessionStart)->Apply(ApplyMappingCounts);
+
+// Session start with the settings of the previous session and the project changed in between
+static void BM_SessionStart(benchmark::State& State)
+{
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    size_t CustomKeyCount = 0;
+    for (auto _ : State)
+    {
+        State.PauseTiming();
+        FRebindSettings Settings;
+        State.ResumeTiming();
+
+        const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+        Settings.RecalculatePlayerMappingSettings(*Defaults, Scenario.GetStoredPacks());
+        CustomKeyCount = Settings.CustomKeys.size();
+    }
+    State.counters["StoredPacks"] = static_cast<double>(Scenario.GetStoredPacks().size());
+    State.counters["CustomKeys"] = static_cast<double>(CustomKeyCount);
+}
+BENCHMARK(BM_SessionStart)->Apply(ApplyMappingCounts);
+
+// Session start of a split screen game: the defaults are collected once, every player only restores its own keys
+static void BM_SessionStartLocalPlayers(benchmark::State& State)
+{
+    constexpr int32_t LocalPlayerCount = 4;
+
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    for (auto _ : State)
+    {
+        State.PauseTiming();
+        std::vector<FRebindSettings> Players(LocalPlayerCount);
+        State.ResumeTiming();
+
+        const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+        for (FRebindSettings& Settings : Players)
+        {
+            Settings.RecalculatePlayerMappingSettings(*Defaults, Scenario.GetStoredPacks());
+        }
+        benchmark::DoNotOptimize(Players.data());
+    }
+    State.counters["LocalPlayers"] = LocalPlayerCount;
+}
+BENCHMARK(BM_SessionStartLocalPlayers)->Apply(ApplyMappingCounts);
+
+// Restoring of the stored keys alone: every stored pack is validated by a single lookup
+static void BM_RestoreStoredKeys(benchmark::State& State)
+{
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+
+    FRebindSettings Settings;
+    for (auto _ : State)
+    {
+        Settings.RecalculatePlayerMappingSettings(*Defaults, Scenario.GetStoredPacks());
+    }
+    State.SetItemsProcessed(State.iterations() * static_cast<int64_t>(Scenario.GetStoredPacks().size()));
+}
+BENCHMARK(BM_RestoreStoredKeys)->Arg(1000)->Arg(10000)->Arg(50000)->Unit(benchmark::kMicrosecond);
+
+static void BM_GetMappingPacksForControlMode(benchmark::State& State)
+{
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+    FRebindSettings Settings;
+    Settings.RecalculatePlayerMappingSettings(*Defaults, Scenario.GetStoredPacks());
+
+    // A refresh of the settings menu: the packs are copied, then every one is unpacked
+    const std::string ControlMode = "KeyboardAndMouse";
+    for (auto _ : State)
+    {
+        for (const FPack& Pack : Settings.GetMappingPacksForControlMode(ControlMode))
+        {
+            benchmark::DoNotOptimize(Defaults->FindMappingDisplayName(Pack)->size());
+            benchmark::DoNotOptimize(Pack.CustomKey);
+        }
+    }
+}
+BENCHMARK(BM_GetMappingPacksForControlMode)->Apply(ApplyMappingCounts);
+
+// A refresh of the settings menu through the handles: every pack is read, none is copied
+static void BM_IterateMappingPackHandles(benchmark::State& State)
+{
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+    FRebindSettings Settings;
+    Settings.RecalculatePlayerMappingSettings(*Defaults, Scenario.GetStoredPacks());
+
+    const std::string ControlMode = "KeyboardAndMouse";
+    for (auto _ : State)
+    {
+        for (const FStandInTraits::FHandle& Handle : Settings.GetMappingPackHandles(ControlMode))
+        {
+            benchmark::DoNotOptimize(Settings.GetMappingDisplayName(Handle).size());
+            benchmark::DoNotOptimize(Settings.GetMappingCustomKey(Handle));
+        }
+    }
+}
+BENCHMARK(BM_IterateMappingPackHandles)->Apply(ApplyMappingCounts);
+
+static void BM_RemapControlKey(benchmark::State& State)
+{
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+    FRebindSettings Settings;
+    Settings.RecalculatePlayerMappingSettings(*Defaults, Scenario.GetStoredPacks());
+    const int32_t EntryCount = static_cast<int32_t>(Defaults->Entries.size());
+
+    // Every remap hits another pack, with the same number of calls to the front and to the back of the settings
+    int32_t EntryIndex = 0;
+    for (auto _ : State)
+    {
+        FPack Pack = Settings.MakePack(EntryIndex);
+        Settings.RemapControlKey(Pack, FStandInKey{(Pack.CustomKey.Id + 1) % KeyCount, Pack.CustomKey.Kind});
+
+        EntryIndex = (EntryIndex + 7919) % EntryCount;
+    }
+    State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_RemapControlKey)->Apply(ApplyMappingCounts);
+
+// Every lookup asks, whether the key of one pack is already used by another one
+static void BM_FindConflictingPack(benchmark::State& State)
+{
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+    FRebindSettings Settings;
+    Settings.RecalculatePlayerMappingSettings(*Defaults, Scenario.GetStoredPacks());
+    const int32_t EntryCount = static_cast<int32_t>(Defaults->Entries.size());
+
+    int32_t EntryIndex = 0;
+    for (auto _ : State)
+    {
+        const FStandInKey CustomKey = Settings.GetCustomKey(EntryIndex);
+        benchmark::DoNotOptimize(Settings.FindConflictingEntryIndex(EntryIndex, FStandInKey{(CustomKey.Id + 1) % KeyCount, CustomKey.Kind}));
+
+        EntryIndex = (EntryIndex + 7919) % EntryCount;
+    }
+    State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_FindConflictingPack)->Apply(ApplyMappingCounts);
+
+// A commit of the player's settings: every context, in which the player has remapped keys, gets its keys in the player's copy
+static void BM_ApplyKeysToPlayerContexts(benchmark::State& State)
+{
+    FSessionScenario Scenario{static_cast<int32_t>(State.range(0))};
+
+    const std::shared_ptr<const FDefaults> Defaults = CollectDefaults(Scenario.GetContexts());
+    FRebindSettings Settings;
+    Settings.RecalculatePlayerMappingSettings(*Defaults, Scenario.GetStoredPacks());
+
+    // The copies are made once, as the controller keeps them between commits
+    std::vector<FStandInContext> PlayerContexts;
+    for (const FStandInContext* SharedContext : Settings.GetRemappedContexts())
+    {
+        PlayerContexts.emplace_back(*SharedContext);
+    }
+
+    for (auto _ : State)
+    {
+        const std::vector<FStandInContext*> RemappedContexts = Settings.GetRemappedContexts();
+        for (size_t Index = 0; Index < RemappedContexts.size(); ++Index)
+        {
+            Settings.ApplyKeysToPlayerContext(*RemappedContexts[Index], PlayerContexts[Index]);
+        }
+        benchmark::DoNotOptimize(PlayerContexts.data());
+    }
+    State.counters["RemappedContexts"] = static_cast<double>(PlayerContexts.size());
+}
+BENCHMARK(BM_ApplyKeysToPlayerContexts)->Apply(ApplyMappingCounts);
@@ -0,0 +1,112 @@
+
+#include "KeyMappingSnapshot.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr std::array<const char*, 8> KeyNames = {
+    "SpaceBar", "LeftShift", "E", "F", "LeftMouseButton",
+    "Gamepad_FaceButton_Bottom", "Gamepad_LeftTrigger", "Gamepad_RightShoulder"};
+
+// Every context holds 50 mappings, as a rather big context of a real project does
+std::vector<std::uint8_t> MakeSnapshot(const int EntryCount)
+{
+    KeyMappingSnapshot::FWriter Writer;
+
+    for (int Index = 0; Index < EntryCount; ++Index)
+    {
+        const std::string Context = "/Game/Input/IMC_Context" + std::to_string(Index / 50);
+        const std::string Action = "/Game/Input/Actions/IA_Action" + std::to_string(Index);
+
+        KeyMappingSnapshot::FEntry Entry;
+        Entry.ContextPathHash = KeyMappingSnapshot::HashPath(Context + '.' + Context.substr(Context.rfind('/') + 1));
+        Entry.ActionPathHash = KeyMappingSnapshot::HashPath(Action + '.' + Action.substr(Action.rfind('/') + 1));
+        Entry.MappingName = Writer.AddName("Mapping_" + std::to_string(Index));
+        Entry.DefaultKey = Writer.AddName(KeyNames[Index % KeyNames.size()]);
+        Entry.CustomKey = Writer.AddName(KeyNames[(Index + 1) % KeyNames.size()]);
+        Entry.MappingIndex = Index % 50;
+
+        Writer.AddEntry(Entry);
+    }
+
+    std::vector<std::uint8_t> Bytes(Writer.GetSize());
+    Writer.WriteTo(Bytes.data());
+    return Bytes;
+}
+
+void ApplyEntryCounts(benchmark::internal::Benchmark* Benchmark)
+{
+    for (const int EntryCount : {100, 1000, 10000, 50000})
+    {
+        Benchmark->Arg(EntryCount);
+    }
+}
+
+} // namespace
+
+
+//////////////////////////////////////////
+
+
+static void BM_SnapshotWrite(benchmark::State& State)
+{
+    for (auto _ : State)
+    {
+        benchmark::DoNotOptimize(MakeSnapshot(static_cast<int>(State.range(0))));
+    }
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_SnapshotWrite)->Apply(ApplyEntryCounts);
+
+// Reading of the file with a single call, validation and resolving of every entry and its names
+static void BM_SnapshotLoad(benchmark::State& State)
+{
+    const std::vector<std::uint8_t> Snapshot = MakeSnapshot(static_cast<int>(State.range(0)));
+
+    const std::string Path = "SnapshotBenchmark.bin";
+    std::FILE* File = std::fopen(Path.c_str(), "wb");
+    std::fwrite(Snapshot.data(), 1, Snapshot.size(), File);
+    std::fclose(File);
+
+    std::vector<std::uint8_t> Bytes;
+
+    for (auto _ : State)
+    {
+        File = std::fopen(Path.c_str(), "rb");
+        std::fseek(File, 0, SEEK_END);
+        Bytes.resize(static_cast<std::size_t>(std::ftell(File)));
+        std::fseek(File, 0, SEEK_SET);
+        const std::size_t ReadSize = std::fread(Bytes.data(), 1, Bytes.size(), File);
+        std::fclose(File);
+
+        KeyMappingSnapshot::FReader Reader;
+        if (ReadSize != Bytes.size() || !Reader.Open(Bytes.data(), Bytes.size()))
+        {
+            State.SkipWithError("The snapshot is not valid");
+            break;
+        }
+
+        for (std::uint32_t Index = 0; Index < Reader.Num(); ++Index)
+        {
+            const KeyMappingSnapshot::FEntry Entry = Reader.GetEntry(Index);
+            benchmark::DoNotOptimize(Entry.ContextPathHash ^ Entry.ActionPathHash);
+            benchmark::DoNotOptimize(Reader.GetName(Entry.MappingName));
+            benchmark::DoNotOptimize(Reader.GetName(Entry.DefaultKey));
+            benchmark::DoNotOptimize(Reader.GetName(Entry.CustomKey));
+        }
+    }
+
+    std::remove(Path.c_str());
+
+    State.SetItemsProcessed(State.iterations() * State.range(0));
+    State.SetBytesProcessed(State.iterations() * static_cast<std::int64_t>(Snapshot.size()));
+    State.counters["SnapshotBytes"] = static_cast<double>(Snapshot.size());
+}
+BENCHMARK(BM_SnapshotLoad)->Apply(ApplyEntryCounts);
@@ -0,0 +1,155 @@
+#pragma once
+
+// Lightweight stand-ins for the engine types, used by RemappingCore outside of the engine
+
+#include "KeyMappingSnapshot.hpp"
+#include "RemappingCore.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+enum class EStandInKeyKind : uint8_t
+{
+    Keyboard,
+    Mouse,
+    Gamepad,
+    Touch,
+    Gesture
+};
+
+// FKey is a wrapper of FName, so it is compared as an integer
+struct FStandInKey
+{
+    int32_t Id = -1;
+    EStandInKeyKind Kind = EStandInKeyKind::Keyboard;
+
+    bool operator==(const FStandInKey& Other) const { return Id == Other.Id; }
+    bool operator!=(const FStandInKey& Other) const { return Id != Other.Id; }
+};
+
+// FName is an index into the global pool of strings
+struct FStandInName
+{
+    int32_t Id = -1;
+
+    static FStandInName Make(const std::string& String)
+    {
+        const auto [It, bIsNew] = GetIds().try_emplace(String, static_cast<int32_t>(GetStrings().size()));
+        if (bIsNew) GetStrings().emplace_back(String);
+        return {It->second};
+    }
+
+    const std::string& ToString() const { return GetStrings()[Id]; }
+
+    bool operator==(const FStandInName& Other) const { return Id == Other.Id; }
+    bool operator!=(const FStandInName& Other) const { return Id != Other.Id; }
+
+private:
+
+    static std::unordered_map<std::string, int32_t>& GetIds()
+    {
+        static std::unordered_map<std::string, int32_t> Ids;
+        return Ids;
+    }
+
+    static std::vector<std::string>& GetStrings()
+    {
+        static std::vector<std::string> Strings;
+        return Strings;
+    }
+};
+
+struct FStandInAction
+{
+    int32_t Id = -1;
+};
+
+struct FStandInMapping
+{
+    const FStandInAction* Action = nullptr;
+    FStandInKey Key;
+    bool bIsPlayerMappable = false;
+    FStandInName MappingName;
+    // Stands for UInputModifierCustomData::CustomDisplayName
+    std::string CustomDisplayName;
+};
+
+struct FStandInContext
+{
+    // Stands for the object path of the asset
+    std::string Path;
+    std::vector<FStandInMapping> Mappings;
+};
+
+
+//////////////////////////////////////////
+
+
+struct FStandInTraits
+{
+    using FKey = FStandInKey;
+    using FText = std::string;
+    using FName = FStandInName;
+    using FContext = FStandInContext;
+    using FAction = FStandInAction;
+    using FMapping = FStandInMapping;
+    using FPack = RemappingCore::TKeyMappingPack<FStandInTraits>;
+    using FHandle = RemappingCore::FEntryHandle;
+
+    static int32_t Num(const FContext& Context) { return static_cast<int32_t>(Context.Mappings.size()); }
+    static FMapping& GetMapping(FContext& Context, const int32_t Index) { return Context.Mappings[Index]; }
+    static bool IsPlayerMappable(const FMapping& Mapping) { return Mapping.bIsPlayerMappable; }
+    static const FAction* GetAction(const FMapping& Mapping) { return Mapping.Action; }
+    static const FKey& GetKey(const FMapping& Mapping) { return Mapping.Key; }
+    static void SetKey(FMapping& Mapping, const FKey& Key) { Mapping.Key = Key; }
+    static bool IsValid(const FKey& Key) { return Key.Id >= 0; }
+    static bool IsNone(const FName& Name) { return Name.Id < 0; }
+    static bool IsEmpty(const FText& Text) { return Text.empty(); }
+    static FName GetMappingName(const FMapping& Mapping) { return Mapping.MappingName; }
+    static size_t GetTypeHash(const FKey& Key) { return static_cast<size_t>(Key.Id); }
+    static size_t GetTypeHash(const FName& Name) { return static_cast<size_t>(Name.Id); }
+    static uint64_t GetPathHash(const FContext& Context) { return KeyMappingSnapshot::HashPath(Context.Path); }
+
+    // The path is built for every call, as FSoftObjectPath::ToString does
+    static uint64_t GetPathHash(const FAction& Action)
+    {
+        const std::string Name = "IA_Action_" + std::to_string(Action.Id);
+        return KeyMappingSnapshot::HashPath("/Game/Input/Actions/" + Name + "." + Name);
+    }
+
+    // Text is returned by value, as FText is
+    static FText GetMappingDisplayName(const FMapping& Mapping)
+    {
+        if (!Mapping.bIsPlayerMappable) return {};
+        if (!Mapping.CustomDisplayName.empty()) return Mapping.CustomDisplayName;
+        return Mapping.MappingName.ToString();
+    }
+
+    // Control modes are compared ignoring case, as FString::Equals with ESearchCase::IgnoreCase does
+    static bool IsSameControlMode(const FText& Left, const FText& Right)
+    {
+        return Left.size() == Right.size()
+            && std::equal(Left.begin(), Left.end(), Right.begin(), [](const char LeftChar, const char RightChar)
+            {
+                return std::tolower(static_cast<unsigned char>(LeftChar)) == std::tolower(static_cast<unsigned char>(RightChar));
+            });
+    }
+
+    static bool IsCorrectControlMode(const FKey& Key, const FText& ControlMode)
+    {
+        switch (Key.Kind)
+        {
+        case EStandInKeyKind::Touch: return IsSameControlMode(ControlMode, "Touch");
+        case EStandInKeyKind::Gesture: return IsSameControlMode(ControlMode, "VR");
+        case EStandInKeyKind::Gamepad: return IsSameControlMode(ControlMode, "Gamepad");
+        case EStandInKeyKind::Keyboard:
+        case EStandInKeyKind::Mouse: return IsSameControlMode(ControlMode, "KeyboardAndMouse");
+        }
+        return false;
+    }
+};
@@ -0,0 +1,254 @@
+#pragma once
+
+// Compact binary snapshot of the player's rebind settings
+// This file depends on the standard library only, so it can be used (and profiled) outside of the engine
+//
+// Layout (little-endian, version 1):
+//   FHeader                                   24 bytes
+//   FEntry[EntryCount]                        32 bytes each
+//   uint32 NameOffsets[NameCount + 1]         offsets into the name blob, the last one is the blob size
+//   char NameBlob[NameBlobSize]               UTF-8, not null-terminated
+//
+// Objects are referenced by the hash of their soft object path, keys and mapping names by their FName string.
+// The reader is a view over the bytes: the whole file can be read with a single call or memory-mapped.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace KeyMappingSnapshot
+{
+
+inline constexpr std::uint32_t Magic = 0x534B4252; // "RBKS"
+inline constexpr std::uint16_t CurrentVersion = 1;
+
+
+//////////////////////////////////////////
+
+
+// FNV-1a. Unlike GetTypeHash, its result never changes between engine versions and platforms
+inline std::uint64_t HashPath(const std::string_view Path)
+{
+    std::uint64_t Hash = 0xCBF29CE484222325ull;
+    for (const char Char : Path)
+    {
+        Hash ^= static_cast<std::uint8_t>(Char);
+        Hash *= 0x100000001B3ull;
+    }
+    return Hash;
+}
+
+inline std::uint32_t HashBytes(const std::uint8_t* Data, const std::size_t Size)
+{
+    std::uint32_t Hash = 0x811C9DC5u;
+    for (std::size_t Index = 0; Index < Size; ++Index)
+    {
+        Hash ^= Data[Index];
+        Hash *= 0x01000193u;
+    }
+    return Hash;
+}
+
+
+//////////////////////////////////////////
+
+
+struct FHeader
+{
+    std::uint32_t Magic = KeyMappingSnapshot::Magic;
+    std::uint16_t Version = CurrentVersion;
+    std::uint16_t HeaderSize = sizeof(FHeader);
+    std::uint32_t EntryCount = 0;
+    std::uint32_t NameCount = 0;
+    std::uint32_t NameBlobSize = 0;
+    // Hash of everything after the header
+    std::uint32_t Checksum = 0;
+};
+static_assert(sizeof(FHeader) == 24);
+
+// Names are stored as indices into the name table
+struct FEntry
+{
+    std::uint64_t ContextPathHash = 0;
+    std::uint64_t ActionPathHash = 0;
+    std::uint32_t MappingName = 0;
+    std::uint32_t DefaultKey = 0;
+    std::uint32_t CustomKey = 0;
+    std::int32_t MappingIndex = -1;
+};
+static_assert(sizeof(FEntry) == 32);
+
+
+//////////////////////////////////////////
+
+
+class FWriter
+{
+public:
+
+    // Returns the index of the name, equal names are stored once
+    std::uint32_t AddName(const std::string_view Name)
+    {
+        const auto [It, bIsNew] = NameIndices.try_emplace(std::string(Name), static_cast<std::uint32_t>(NameOffsets.size()));
+        if (bIsNew)
+        {
+            NameOffsets.emplace_back(static_cast<std::uint32_t>(NameBlob.size()));
+            NameBlob.append(Name);
+        }
+        return It->second;
+    }
+
+    void AddEntry(const FEntry& Entry)
+    {
+        Entries.emplace_back(Entry);
+    }
+
+    /////////////////////
+
+    [[nodiscard]] std::size_t GetSize() const
+    {
+        return sizeof(FHeader)
+            + Entries.size() * sizeof(FEntry)
+            + (NameOffsets.size() + 1) * sizeof(std::uint32_t)
+            + NameBlob.size();
+    }
+
+    // Destination must hold at least GetSize() bytes
+    void WriteTo(std::uint8_t* Destination) const
+    {
+        FHeader Header;
+        Header.EntryCount = static_cast<std::uint32_t>(Entries.size());
+        Header.NameCount = static_cast<std::uint32_t>(NameOffsets.size());
+        Header.NameBlobSize = static_cast<std::uint32_t>(NameBlob.size());
+
+        std::uint8_t* Cursor = Destination + sizeof(FHeader);
+
+        std::memcpy(Cursor, Entries.data(), Entries.size() * sizeof(FEntry));
+        Cursor += Entries.size() * sizeof(FEntry);
+
+        std::memcpy(Cursor, NameOffsets.data(), NameOffsets.size() * sizeof(std::uint32_t));
+        Cursor += NameOffsets.size() * sizeof(std::uint32_t);
+
+        std::memcpy(Cursor, &Header.NameBlobSize, sizeof(std::uint32_t));
+        Cursor += sizeof(std::uint32_t);
+
+        std::memcpy(Cursor, NameBlob.data(), NameBlob.size());
+
+        const std::uint8_t* Body = Destination + sizeof(FHeader);
+        Header.Checksum = HashBytes(Body, GetSize() - sizeof(FHeader));
+
+        std::memcpy(Destination, &Header, sizeof(FHeader));
+    }
+
+private:
+
+    std::vector<FEntry> Entries;
+    std::vector<std::uint32_t> NameOffsets;
+    std::string NameBlob;
+    std::unordered_map<std::string, std::uint32_t> NameIndices;
+};
+
+
+//////////////////////////////////////////
+
+
+// Does not own the data, so the bytes must outlive the reader
+class FReader
+{
+public:
+
+    // Returns false, if the data is not a valid snapshot of the current version
+    [[nodiscard]] bool Open(const std::uint8_t* InData, const std::size_t InSize)
+    {
+        Data = nullptr;
+        Header = FHeader{};
+
+        if (!InData || InSize < sizeof(FHeader)) return false;
+
+        FHeader ReadHeader;
+        std::memcpy(&ReadHeader, InData, sizeof(FHeader));
+
+        const bool bIsKnownFormat = true
+            && ReadHeader.Magic == Magic
+            && ReadHeader.Version == CurrentVersion
+            && ReadHeader.HeaderSize == sizeof(FHeader);
+        if (!bIsKnownFormat) return false;
+
+        const std::size_t ExpectedSize = sizeof(FHeader)
+            + std::size_t{ReadHeader.EntryCount} * sizeof(FEntry)
+            + (std::size_t{ReadHeader.NameCount} + 1) * sizeof(std::uint32_t)
+            + ReadHeader.NameBlobSize;
+        if (InSize != ExpectedSize) return false;
+
+        // Any damage of the file leads to the loss of the settings, but never to the wrong keys
+        if (HashBytes(InData + sizeof(FHeader), InSize - sizeof(FHeader)) != ReadHeader.Checksum) return false;
+
+        Data = InData;
+        Header = ReadHeader;
+
+        // Names are validated once here, so GetName never has to
+        for (std::uint32_t Index = 0; Index < Header.NameCount; ++Index)
+        {
+            if (GetNameOffset(Index) > GetNameOffset(Index + 1) || GetNameOffset(Index + 1) > Header.NameBlobSize)
+            {
+                Data = nullptr;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /////////////////////
+
+    [[nodiscard]] std::uint32_t Num() const
+    {
+        return Header.EntryCount;
+    }
+
+    [[nodiscard]] FEntry GetEntry(const std::uint32_t Index) const
+    {
+        FEntry Entry;
+        std::memcpy(&Entry, Data + sizeof(FHeader) + std::size_t{Index} * sizeof(FEntry), sizeof(FEntry));
+        return Entry;
+    }
+
+    // Returns an empty view for indices outside of the name table
+    [[nodiscard]] std::string_view GetName(const std::uint32_t Index) const
+    {
+        if (Index >= Header.NameCount) return {};
+
+        const std::uint32_t Begin = GetNameOffset(Index);
+        const std::uint32_t End = GetNameOffset(Index + 1);
+        return {reinterpret_cast<const char*>(GetNameBlob()) + Begin, End - Begin};
+    }
+
+private:
+
+    [[nodiscard]] const std::uint8_t* GetNameOffsets() const
+    {
+        return Data + sizeof(FHeader) + std::size_t{Header.EntryCount} * sizeof(FEntry);
+    }
+
+    [[nodiscard]] const std::uint8_t* GetNameBlob() const
+    {
+        return GetNameOffsets() + (std::size_t{Header.NameCount} + 1) * sizeof(std::uint32_t);
+    }
+
+    [[nodiscard]] std::uint32_t GetNameOffset(const std::uint32_t Index) const
+    {
+        std::uint32_t Offset = 0;
+        std::memcpy(&Offset, GetNameOffsets() + std::size_t{Index} * sizeof(std::uint32_t), sizeof(std::uint32_t));
+        return Offset;
+    }
+
+    const std::uint8_t* Data = nullptr;
+    FHeader Header;
+};
+
+} // namespace KeyMappingSnapshot
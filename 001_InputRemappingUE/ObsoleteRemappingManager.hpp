@@ -9,6 +9,41 @@
 #include "EnhancedInput/Public/InputMappingContext.h"
 #include "EnhancedInputSubsystems.h"
 ////////
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Tasks/Task.h"
+#include "UObject/SoftObjectPath.h"
+#include "KeyMappingSnapshot.hpp"
+////////
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+
+DEFINE_LOG_CATEGORY_STATIC(LogRebindSetting, Log, All);
+
+// Phases of the session start are traced as CPU scopes, readable by Unreal Insights
+// The counters and the cycle stats below are seen with "stat RebindSetting" and in Insights with the stats channel enabled
+DECLARE_STATS_GROUP(TEXT("Rebind Setting"), STATGROUP_RebindSetting, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("GetMappingPacksForControlMode"), STAT_RebindSetting_GetMappingPacksForControlMode, STATGROUP_RebindSetting);
+DECLARE_CYCLE_STAT(TEXT("RemapControlKey"), STAT_RebindSetting_RemapControlKey, STATGROUP_RebindSetting);
+
+// Accumulators are not reset every frame, so they keep the numbers of the last session start
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Contexts scanned"), STAT_RebindSetting_ContextsScanned, STATGROUP_RebindSetting);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Contexts loaded synchronously"), STAT_RebindSetting_ContextsLoadedSynchronously, STATGROUP_RebindSetting);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Stored packs validated"), STAT_RebindSetting_PacksValidated, STATGROUP_RebindSetting);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Stored packs dropped as obsolete"), STAT_RebindSetting_PacksDropped, STATGROUP_RebindSetting);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Similar mapping lookups"), STAT_RebindSetting_SimilarMappingLookups, STATGROUP_RebindSetting);
+
+// The engine-independent core reports into the same checks, trace scopes and stats
+#define REMAPPING_CORE_CHECK(Expression) check(Expression)
+#define REMAPPING_CORE_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE(Name)
+#define REMAPPING_CORE_SET_COUNTER(Name, Value) SET_DWORD_STAT(STAT_RebindSetting_##Name, Value)
+
+#include "RemappingCore.hpp"
+////////
 #include "ObsoleteRemappingManager.generated.h"
 
 
@@ -52,6 +87,8 @@ struct FKeyMappingPack
     GENERATED_BODY();
 
     friend class URebindSettingController;
+    friend struct FRebindSettingTraits;
+    template <typename> friend class RemappingCore::TRebindSettings;
 
 public:
 
@@ -67,12 +104,18 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rebind Setting")
     FKey CustomKey{NAME_None};
 
+    // Interned identity of the mapping, so packs are compared as integers
+    // Its display name is resolved once per mapping and kept by the controller
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rebind Setting")
-    FText MappingDisplayName;
+    FName MappingName{NAME_None};
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rebind Setting")
     int32 MappingIndex = -1;
 
+    // Kept only for Blueprint graphs, which still read it: filled for the packs the controller hands out, never saved
+    UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category = "Rebind Setting", meta = (DeprecatedProperty, DeprecationMessage = "Use UnpackRebindPack of the Rebind Setting Controller instead"))
+    FText MappingDisplayName;
+
 public:
 
     // This constructor is for Editor only
@@ -87,7 +130,7 @@ public:
         && Other.MappingContext == MappingContext
         && Other.MappingAction == MappingAction
         && Other.CustomKey == CustomKey
-        && Other.MappingDisplayName.EqualTo(MappingDisplayName)
+        && Other.MappingName == MappingName
         && Other.MappingIndex == MappingIndex;
     }
 
@@ -100,19 +143,19 @@ private:
 
     /////////////////////
 
-    FKeyMappingPack(UInputMappingContext* Context, const UInputAction* Action, const FKey& KeyToStore, const int32 KeyIndex, const FText& MappingName) : 
+    FKeyMappingPack(UInputMappingContext* Context, const UInputAction* Action, const FKey& KeyToStore, const int32 KeyIndex, const FName Name) : 
         MappingContext(Context),
         MappingAction(Action),
         DefaultKey(KeyToStore),
         CustomKey(KeyToStore),
-        MappingDisplayName(MappingName),
+        MappingName(Name),
         MappingIndex(KeyIndex)
     {
         check(MappingContext);
         check(MappingAction);
         check(DefaultKey.IsValid());
         check(CustomKey.IsValid());
-        check(!MappingDisplayName.IsEmpty());
+        check(!MappingName.IsNone());
         check(KeyIndex >= 0);
     }
 
@@ -134,75 +177,93 @@ private:
 
         return FText::FromName(Mapping.GetMappingName());
     }
+};
 
-    /////////////////////
 
-    // Searches the context for an input mapping, with identical name and action
-    FEnhancedActionKeyMapping* ExtractSimilarMapping(UInputMappingContext* OtherContext) const
-    {
-        const bool bIsWrongContext =
-            // Contexts are just different
-            OtherContext != MappingContext
-            // Current mapping was changed, so as this pack is invalid now
-            || OtherContext->GetMappings().Num() <= MappingIndex;
+//////////////////////////////////////////
 
-        if (bIsWrongContext) return nullptr;
 
-        // We assume, the mapping under the stored number is the same mapping we created this pack with
-        // So, in case of any inconsistencies, this pack is deemed invalid
-        FEnhancedActionKeyMapping& MappingUnderThisNumber = OtherContext->GetMapping(MappingIndex);
+// Light reference to a pack of the current game session: the index of its default mapping in the shared table
+// and the generation of that table. Handles stay valid until the table is rebuilt, so the UI may keep them instead of copies of the packs
+// Whether the table is still the same is known only to the controller, see URebindSettingController::IsValidMappingPackHandle
+USTRUCT(BlueprintType, Category = "Rebind Setting")
+struct FKeyMappingHandle
+{
+    GENERATED_BODY();
 
-        // Do not consider non-editable mappings
-        if (!MappingUnderThisNumber.IsPlayerMappable()) return nullptr;
+    friend class URebindSettingController;
+    template <typename> friend class RemappingCore::TRebindSettings;
+
+public:
 
-        // If the action, default key or its display name are different, this pack is deemed invalid
-        const bool bIsPackValid = true
-            && MappingUnderThisNumber.Action == MappingAction
-            && GetMappingDisplayName(MappingUnderThisNumber).EqualTo(MappingDisplayName);
-        if (!bIsPackValid) return nullptr;
+    FKeyMappingHandle() = default;
 
-        // Return a pointer to the editable mapping of the same pack profile
-        return &MappingUnderThisNumber;
+    // Whether the handle was made by a controller at all
+    [[nodiscard]] bool IsValid() const
+    {
+        return EntryIndex != INDEX_NONE;
     }
-};
 
+    FORCEINLINE bool operator==(const FKeyMappingHandle& Other) const
+    {
+        return Other.EntryIndex == EntryIndex && Other.Generation == Generation;
+    }
 
-//////////////////////////////////////////
+    FORCEINLINE bool operator!=(const FKeyMappingHandle& Other) const
+    {
+        return !(*this == Other);
+    }
 
+private:
 
-UCLASS(NotBlueprintType, NotBlueprintable, Category = "Rebind Setting")
-class URebindSettingController : public UObject
-{
-    GENERATED_BODY()
+    FKeyMappingHandle(const int32 InEntryIndex, const uint32 InGeneration) : EntryIndex(InEntryIndex), Generation(InGeneration)
+    {
+    }
 
-private:
+    UPROPERTY()
+    int32 EntryIndex = INDEX_NONE;
 
-    // Input User settings, stored between game sessions
-    // The settings are stored only in shipping builds for debug reasons!
     UPROPERTY()
-    TArray<FKeyMappingPack> StableKeyMappingPacks;
+    uint32 Generation = 0;
+};
 
-private:
 
-    // In Shipping build no keys are restored on game's end!
-    #if !UE_BUILD_SHIPPING
-    void BeginDestroy() override
-    {
-        Super::BeginDestroy();
+//////////////////////////////////////////
 
-        // Restores all
-        for (FKeyMappingPack& OnePack : StableKeyMappingPacks)
-        {
-            RestoreDefaultKey(OnePack);
-        }
-    }
-    #endif // !UE_BUILD_SHIPPING
 
-////////////////////////////
+// Engine types and calls, on which the engine-independent core of the controller is instantiated
+struct FRebindSettingTraits
+{
+    using FKey = ::FKey;
+    using FText = ::FText;
+    using FName = ::FName;
+    using FContext = UInputMappingContext;
+    using FAction = UInputAction;
+    using FMapping = FEnhancedActionKeyMapping;
+    using FPack = FKeyMappingPack;
+    using FHandle = FKeyMappingHandle;
+
+    static int32 Num(const UInputMappingContext& Context) { return Context.GetMappings().Num(); }
+    static FEnhancedActionKeyMapping& GetMapping(UInputMappingContext& Context, const int32 Index) { return Context.GetMapping(Index); }
+    static bool IsPlayerMappable(const FEnhancedActionKeyMapping& Mapping) { return Mapping.IsPlayerMappable(); }
+    static const UInputAction* GetAction(const FEnhancedActionKeyMapping& Mapping) { return Mapping.Action.Get(); }
+    static const FKey& GetKey(const FEnhancedActionKeyMapping& Mapping) { return Mapping.Key; }
+    static void SetKey(FEnhancedActionKeyMapping& Mapping, const FKey& Key) { Mapping.Key = Key; }
+    static bool IsValid(const FKey& Key) { return Key.IsValid(); }
+    static bool IsNone(const FName Name) { return Name.IsNone(); }
+    static FName GetMappingName(const FEnhancedActionKeyMapping& Mapping) { return Mapping.GetMappingName(); }
+    static FText GetMappingDisplayName(const FEnhancedActionKeyMapping& Mapping) { return FKeyMappingPack::GetMappingDisplayName(Mapping); }
+    static bool IsEmpty(const FText& Text) { return Text.IsEmptyOrWhitespace(); }
+    static uint32 GetTypeHash(const FKey& Key) { return GetTypeHashHelper(Key); }
+    static uint32 GetTypeHash(const FName Name) { return GetTypeHashHelper(Name); }
+
+    static bool IsSameControlMode(const FText& Left, const FText& Right)
+    {
+        return Left.ToString().Equals(Right.ToString(), ESearchCase::IgnoreCase);
+    }
 
-    static bool IsCorrectControlMode(const FKeyMappingPack& RebindPack, const FText& ControlMode)
+    static bool IsCorrectControlMode(const FKey& KeyToSelect, const FText& ControlMode)
     {
-        const FKey KeyToSelect = RebindPack.CustomKey;
         const FString& ControlModeString = ControlMode.ToString();
 
         if (KeyToSelect.IsTouch() && ControlModeString.Equals("Touch", ESearchCase::IgnoreCase))
@@ -225,119 +286,450 @@ private:
         return bIsKeyboardOrMouse && ControlModeString.Equals("KeyboardAndMouse", ESearchCase::IgnoreCase);
     }
 
-////////////////////////////
+    // The same hash of the object path, under which the snapshot stores contexts and actions
+    static uint64 GetPathHash(const UObject& Object)
+    {
+        const FString Path = FSoftObjectPath(&Object).ToString();
+        const auto Utf8 = StringCast<UTF8CHAR>(*Path);
+
+        return KeyMappingSnapshot::HashPath({reinterpret_cast<const char*>(Utf8.Get()), static_cast<size_t>(Utf8.Length())});
+    }
+};
+
+
+//////////////////////////////////////////
+
+
+// Writes snapshots of the settings on a background thread, so a rebind never waits for the save storage
+// Snapshots requested, while a write is in flight, are coalesced: only the latest one is written after it
+class FKeyMappingSnapshotPersister
+{
+public:
+
+    // Everything a snapshot entry needs, taken on the game thread: the background thread touches no UObject
+    struct FStoredMapping
+    {
+        uint64 ContextPathHash = 0;
+        uint64 ActionPathHash = 0;
+        FName MappingName{NAME_None};
+        FName DefaultKey{NAME_None};
+        FName CustomKey{NAME_None};
+        int32 MappingIndex = -1;
+    };
+
+    explicit FKeyMappingSnapshotPersister(const FString& InPath) : Path(InPath)
+    {
+    }
 
-    static void CollectContextsWithMappableKeys(TArray<UInputMappingContext*>& CurrentContexts)
+    ~FKeyMappingSnapshotPersister()
     {
-        CurrentContexts.Empty();
+        Flush();
+    }
+
+    FKeyMappingSnapshotPersister(const FKeyMappingSnapshotPersister&) = delete;
+    FKeyMappingSnapshotPersister& operator=(const FKeyMappingSnapshotPersister&) = delete;
+
+    /////////////////////
+
+    // The new snapshot is written into this file first and then moved over the old one
+    static FString GetTempPath(const FString& SnapshotPath)
+    {
+        return SnapshotPath + TEXT(".tmp");
+    }
+
+    // Must be called on the game thread only
+    void Enqueue(TArray<FStoredMapping>&& Mappings)
+    {
+        check(IsInGameThread());
+
+        FScopeLock Lock(&Mutex);
 
-        const TArray<UInputMappingContext*> AllContexts = FindAllInputMappingContexts();
+        // A snapshot, which has not been taken by the writer yet, is replaced by the newer one
+        PendingMappings = MoveTemp(Mappings);
+        bHasPendingMappings = true;
 
-        // KeyMappingPack are formed from the MappingContexts
-        check(!AllContexts.IsEmpty());
+        if (bIsWriting) return;
+        bIsWriting = true;
 
-        for (UInputMappingContext* OneContext : AllContexts)
+        // The write must never take a worker from the game's own tasks
+        WriteTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this] { WritePendingSnapshots(); }, UE::Tasks::ETaskPriority::BackgroundNormal);
+    }
+
+    // Blocks, until every enqueued snapshot is written
+    void Flush()
+    {
+        check(IsInGameThread());
+
+        if (WriteTask.IsValid())
         {
-            const TArray<FEnhancedActionKeyMapping> Mappings = OneContext->GetMappings();
-            if (Mappings.IsEmpty()) continue;
+            WriteTask.Wait();
+        }
+    }
 
-            for (int Index = 0; Index < Mappings.Num(); ++Index)
+private:
+
+    // Runs on the background thread, until no snapshot is pending
+    void WritePendingSnapshots()
+    {
+        for (;;)
+        {
+            TArray<FStoredMapping> Mappings;
             {
-                const FEnhancedActionKeyMapping& OneMapping = Mappings[Index];
+                FScopeLock Lock(&Mutex);
 
-                // Skip, if this mapping is not editable
-                if (!OneMapping.IsPlayerMappable()) continue;
+                if (!bHasPendingMappings)
+                {
+                    bIsWriting = false;
+                    return;
+                }
 
-                CurrentContexts.Emplace(OneContext);
+                Mappings = MoveTemp(PendingMappings);
+                bHasPendingMappings = false;
             }
-        }
 
-        // Something went wrong is no context had at least one mappable mapping
-        check(!CurrentContexts.IsEmpty());
+            WriteSnapshot(Mappings);
+        }
     }
 
-    void RestoreStoredKeysAndRemoveObsoleteMappings(const TArray<UInputMappingContext*>& CurrentContexts)
+    void WriteSnapshot(const TArray<FStoredMapping>& Mappings) const
     {
-        if (StableKeyMappingPacks.IsEmpty() || CurrentContexts.IsEmpty()) return;
+        TRACE_CPUPROFILER_EVENT_SCOPE(FKeyMappingSnapshotPersister::WriteSnapshot);
+
+        KeyMappingSnapshot::FWriter Writer;
 
-        const auto RemoveObsoletePacksAndResetStoredKeys = [&CurrentContexts](const FKeyMappingPack& OneStablePack)->bool
+        for (const FStoredMapping& Mapping : Mappings)
         {
-            for (UInputMappingContext* Context : CurrentContexts)
-            {
-                // Look for a mapping with similar name and input action
-                FEnhancedActionKeyMapping* Mapping = OneStablePack.ExtractSimilarMapping(Context);
+            KeyMappingSnapshot::FEntry Entry;
+            Entry.ContextPathHash = Mapping.ContextPathHash;
+            Entry.ActionPathHash = Mapping.ActionPathHash;
+            Entry.MappingName = AddSnapshotName(Writer, Mapping.MappingName);
+            Entry.DefaultKey = AddSnapshotName(Writer, Mapping.DefaultKey);
+            Entry.CustomKey = AddSnapshotName(Writer, Mapping.CustomKey);
+            Entry.MappingIndex = Mapping.MappingIndex;
+
+            Writer.AddEntry(Entry);
+        }
 
-                // Skip, if this context does not contain the respective mapping OR it is not editable
-                if (!Mapping || !Mapping->IsPlayerMappable()) continue;
+        TArray<uint8> Bytes;
+        Bytes.SetNumUninitialized(Writer.GetSize());
+        Writer.WriteTo(Bytes.GetData());
 
-                // If this context has the similar mapping, assign this the stored key
-                Mapping->Key = OneStablePack.CustomKey;
+        // The old snapshot is replaced only by a completely written new one
+        const FString TempPath = GetTempPath(Path);
+        if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath))
+        {
+            UE_LOG(LogRebindSetting, Error, TEXT("Key mappings are not saved: %s can not be written"), *TempPath);
+            return;
+        }
 
-                // This pack has proved to be still valid and must persist for this game session
-                return true;
-            }
+        // The temporary file stays and is still found by the next load, as it is the newer one
+        if (!IFileManager::Get().Move(*Path, *TempPath, /*bReplace*/ true, /*bEvenIfReadOnly*/ true))
+        {
+            UE_LOG(LogRebindSetting, Warning, TEXT("Key mappings are saved only into %s: it can not be moved to %s"), *TempPath, *Path);
+        }
+    }
 
-            // This pack lost its respective mapping and must be removed
-            return false;
-        };
-        StableKeyMappingPacks = StableKeyMappingPacks.FilterByPredicate(RemoveObsoletePacksAndResetStoredKeys);
+    static uint32 AddSnapshotName(KeyMappingSnapshot::FWriter& Writer, const FName Name)
+    {
+        const FString String = Name.ToString();
+        const auto Utf8 = StringCast<UTF8CHAR>(*String);
+
+        return Writer.AddName({reinterpret_cast<const char*>(Utf8.Get()), static_cast<size_t>(Utf8.Length())});
     }
 
-    void CollectNewControlSettings(const TArray<UInputMappingContext*>& CurrentContexts)
+    /////////////////////
+
+    const FString Path;
+
+    FCriticalSection Mutex;
+    TArray<FStoredMapping> PendingMappings;
+    bool bHasPendingMappings = false;
+    bool bIsWriting = false;
+
+    // Touched by the game thread only
+    UE::Tasks::FTask WriteTask;
+};
+
+
+//////////////////////////////////////////
+
+
+// Default key mappings of all contexts, collected once per session and shared by the controllers of all local players
+// It is never changed after being built: every player keeps only the keys remapped on top of it
+struct FKeyMappingDefaults : public RemappingCore::TKeyMappingDefaults<FRebindSettingTraits>, public FGCObject
+{
+    // Contexts with mappable keys are kept alive while the table exists
+    void AddReferencedObjects(FReferenceCollector& Collector) override
     {
-        for (UInputMappingContext* OneContext : CurrentContexts)
+        for (UInputMappingContext*& Context : Contexts)
         {
-            const TArray<FEnhancedActionKeyMapping> Mappings = OneContext->GetMappings();
-            if (Mappings.IsEmpty()) continue;
+            Collector.AddReferencedObject(Context);
+        }
+    }
+
+    FString GetReferencerName() const override
+    {
+        return TEXT("FKeyMappingDefaults");
+    }
+};
+
+
+//////////////////////////////////////////
 
-            for (int KeyIndex = 0; KeyIndex < Mappings.Num(); ++KeyIndex)
-            {
-                const FEnhancedActionKeyMapping& OneMapping = Mappings[KeyIndex];
 
-                // Skip, if this mapping is not editable
-                if (!OneMapping.IsPlayerMappable()) continue;
+// Every local player plays with its own keys: the shared UInputMappingContext assets always keep their default keys,
+// while the contexts this player has remapped are replaced by its own copies in its UEnhancedInputLocalPlayerSubsystem
+UCLASS(NotBlueprintType, NotBlueprintable, Category = "Rebind Setting")
+class URebindSettingController : public UObject
+{
+    GENERATED_BODY()
 
-                const FText& DisplayName = FKeyMappingPack::GetMappingDisplayName(OneMapping);
-                check(!DisplayName.IsEmptyOrWhitespace());
+private:
 
-                const UInputAction* OneAction = OneMapping.Action.Get();
-                check(OneAction);
+    // Input User settings of the old format, saved with the settings object
+    // They are read once to migrate into the binary snapshot and emptied right after that
+    UPROPERTY()
+    TArray<FKeyMappingPack> StableKeyMappingPacks;
 
-                const FKey DefaultKey = OneMapping.Key;
-                check(DefaultKey.IsValid());
+    // Default mappings of the current game session, shared with other local players
+    TSharedPtr<const FKeyMappingDefaults> DefaultKeyMappings;
 
-                FKeyMappingPack PackToAdd{OneContext, OneAction, DefaultKey, KeyIndex, DisplayName};
+    // Input User settings of the current game session: keys, which differ from the defaults, on top of the shared table
+    // The settings are stored between game sessions only in shipping builds for debug reasons!
+    RemappingCore::TRebindSettings<FRebindSettingTraits> RebindSettings;
 
-                //  Skip, if this mapping has already been stored
-                const auto HasAlreadyPacked = [&PackToAdd](const FKeyMappingPack& Pack)
-                {
-                    return (Pack == PackToAdd);
-                };
-                if (static_cast<bool>(StableKeyMappingPacks.FindByPredicate(HasAlreadyPacked))) continue;
+    // Copies of the shared contexts, in which this player has remapped keys, by the shared contexts
+    // They are created on the first remap in the context and dropped, once all its keys are default again
+    UPROPERTY()
+    TMap<UInputMappingContext*, UInputMappingContext*> PlayerMappingContexts;
 
-                StableKeyMappingPacks.Emplace(MoveTemp(PackToAdd));
-            }
+    // Index of the local player, whose settings are kept by this controller
+    int32 LocalPlayerIndex = 0;
+
+    // Writes the settings of this player in the background, created at the start of a game session
+    TUniquePtr<FKeyMappingSnapshotPersister> SnapshotPersister;
+
+private:
+
+    void BeginDestroy() override
+    {
+        Super::BeginDestroy();
+
+        // No keys are restored on game's end: the shared contexts have never been changed,
+        // and the copies of this player are destroyed along with the controller
+
+        // The settings are not lost, if the game ends right after a rebind
+        if (SnapshotPersister.IsValid())
+        {
+            SnapshotPersister->Flush();
+        }
+    }
+
+////////////////////////////
+
+    static uint32& GetKeyMappingSession()
+    {
+        static uint32 KeyMappingSession = 0;
+        return KeyMappingSession;
+    }
+
+    // Returns the default mappings of the current session, collecting them, if no controller holds them anymore or a new session has started
+    // The shared contexts always have their default keys, so a new table may be collected, while controllers still hold the previous one
+    static TSharedRef<const FKeyMappingDefaults> GetOrCollectDefaultKeyMappings()
+    {
+        static TWeakPtr<const FKeyMappingDefaults> SharedDefaults;
+        static uint32 SharedDefaultsSession = 0;
+
+        const TSharedPtr<const FKeyMappingDefaults> PreviousDefaults = SharedDefaults.Pin();
+        if (PreviousDefaults.IsValid() && SharedDefaultsSession == GetKeyMappingSession())
+        {
+            return PreviousDefaults.ToSharedRef();
         }
+
+        // Collect contexts with mappable keys and their default mappings
+        const TSharedRef<FKeyMappingDefaults> Defaults = MakeShared<FKeyMappingDefaults>();
+        Defaults->Collect(FindAllInputMappingContexts());
+
+        SharedDefaults = Defaults;
+        SharedDefaultsSession = GetKeyMappingSession();
+        return Defaults;
     }
 
-    // This function must be called once at the start of every game session
+    // This function must be called once at the start of every game session for every local player
     // This function restores valid control settings, removes obsolete ones and adds new ones
-    void RecalculatePlayerMappingSettings()
+    void RecalculatePlayerMappingSettings(const int32 InLocalPlayerIndex = 0)
     {
+        TRACE_CPUPROFILER_EVENT_SCOPE(URebindSettingController::RecalculatePlayerMappingSettings);
+
+        LocalPlayerIndex = InLocalPlayerIndex;
+
+        // Collect new control settings, once for all local players
+        DefaultKeyMappings = GetOrCollectDefaultKeyMappings();
+
         // The settings are stored between game sessions only in shipping builds for debug reasons!
-        #if !UE_BUILD_SHIPPING
-        StableKeyMappingPacks.Empty();
-        #endif // !UE_BUILD_SHIPPING
+        TArray<FKeyMappingPack> StoredPacks;
 
-        // Collect contexts with mappable keys
-        TArray<UInputMappingContext*> CurrentContexts;
-        CollectContextsWithMappableKeys(CurrentContexts);
+        #if UE_BUILD_SHIPPING
+        // The previous persister writes everything it has before the snapshot is read
+        SnapshotPersister = MakeUnique<FKeyMappingSnapshotPersister>(GetKeyMappingSnapshotPath());
+
+        // Read the stored keys from the snapshot or, if there is none yet, take the settings of the old format
+        const bool bIsMigrationNeeded = !LoadKeyMappingSnapshot(StoredPacks) && !StableKeyMappingPacks.IsEmpty();
+        if (bIsMigrationNeeded)
+        {
+            MigrateStableKeyMappingPacks(StoredPacks);
+        }
+        StableKeyMappingPacks.Empty();
+        #endif // UE_BUILD_SHIPPING
 
         // Restore keys from settings in valid mappings and remove obsolete ones
-        RestoreStoredKeysAndRemoveObsoleteMappings(CurrentContexts);
+        RebindSettings.RecalculatePlayerMappingSettings(*DefaultKeyMappings, StoredPacks);
+
+        // Copies of the previous session may differ from the contexts of this one, so they are made anew with the restored keys
+        DropPlayerMappingContexts();
+        RebuildControlMappings();
+
+        #if UE_BUILD_SHIPPING
+        // The migrated settings are saved in the new format at once
+        if (bIsMigrationNeeded)
+        {
+            ApplyRebindSettings();
+        }
+        #endif // UE_BUILD_SHIPPING
+    }
+
+////////////////////////////
+
+    // Settings of the old format have no mapping names, so they are taken from the mappings the packs point to
+    void MigrateStableKeyMappingPacks(TArray<FKeyMappingPack>& StoredPacks) const
+    {
+        StoredPacks.Reset(StableKeyMappingPacks.Num());
 
-        // Collect new control setting
-        CollectNewControlSettings(CurrentContexts);
+        for (const FKeyMappingPack& OldPack : StableKeyMappingPacks)
+        {
+            const auto EntryIndex = DefaultKeyMappings->EntryIndicesByMapping.find({OldPack.MappingContext, OldPack.MappingIndex});
+            if (EntryIndex == DefaultKeyMappings->EntryIndicesByMapping.end()) continue;
+
+            // Skip, if the mapping under the stored number is not the one this pack was created with
+            const FKeyMappingDefaults::FEntry& Entry = DefaultKeyMappings->Entries[EntryIndex->second];
+            if (Entry.MappingAction != OldPack.MappingAction) continue;
+
+            FKeyMappingPack& Pack = StoredPacks.Emplace_GetRef(OldPack);
+            Pack.MappingName = Entry.MappingName;
+        }
+    }
+
+////////////////////////////
+
+    // Settings of the first local player keep the file name they had before split screen support
+    FString GetKeyMappingSnapshotPath() const
+    {
+        const FString FileName = LocalPlayerIndex == 0
+            ? FString(TEXT("KeyMappings.bin"))
+            : FString::Printf(TEXT("KeyMappings_%d.bin"), LocalPlayerIndex);
+
+        return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), FileName);
+    }
+
+    static FName GetSnapshotName(const KeyMappingSnapshot::FReader& Reader, const uint32 Index)
+    {
+        const std::string_view Name = Reader.GetName(Index);
+        const auto Converted = StringCast<TCHAR>(reinterpret_cast<const UTF8CHAR*>(Name.data()), static_cast<int32>(Name.size()));
+
+        return FName(Converted.Length(), Converted.Get());
+    }
+
+    // The whole file is read with a single call, the reader points into the bytes
+    static bool OpenKeyMappingSnapshot(const FString& FilePath, TArray<uint8>& Bytes, KeyMappingSnapshot::FReader& Reader)
+    {
+        return true
+            && FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent)
+            && Reader.Open(Bytes.GetData(), Bytes.Num());
+    }
+
+    // Fills the stored packs with the entries of the snapshot, whose contexts and actions still exist
+    // Returns false, if there is no snapshot or it is damaged
+    bool LoadKeyMappingSnapshot(TArray<FKeyMappingPack>& StoredPacks) const
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(URebindSettingController::LoadKeyMappingSnapshot);
+
+        // A write, interrupted before the move or with a failed move, leaves the temporary file next to the snapshot
+        // A torn temporary file fails the checksum, so of two valid files the newer one has the latest keys
+        const FString Path = GetKeyMappingSnapshotPath();
+        const FString TempPath = FKeyMappingSnapshotPersister::GetTempPath(Path);
+
+        TArray<uint8> Bytes;
+        TArray<uint8> TempBytes;
+        KeyMappingSnapshot::FReader MainReader;
+        KeyMappingSnapshot::FReader TempReader;
+
+        const bool bIsMainValid = OpenKeyMappingSnapshot(Path, Bytes, MainReader);
+        const bool bIsTempValid = OpenKeyMappingSnapshot(TempPath, TempBytes, TempReader);
+        if (!bIsMainValid && !bIsTempValid) return false;
+
+        const bool bIsTempNewer = bIsTempValid
+            && (!bIsMainValid || IFileManager::Get().GetTimeStamp(*TempPath) > IFileManager::Get().GetTimeStamp(*Path));
+        const KeyMappingSnapshot::FReader& Reader = bIsTempNewer ? TempReader : MainReader;
+
+        StoredPacks.Reset(Reader.Num());
+
+        for (uint32 Index = 0; Index < Reader.Num(); ++Index)
+        {
+            const KeyMappingSnapshot::FEntry Entry = Reader.GetEntry(Index);
+
+            // Skip, if the context of this entry was removed or changed
+            const auto Context = DefaultKeyMappings->ContextsByPathHash.find(Entry.ContextPathHash);
+            if (Context == DefaultKeyMappings->ContextsByPathHash.end()) continue;
+
+            const auto EntryIndex = DefaultKeyMappings->EntryIndicesByMapping.find({Context->second, Entry.MappingIndex});
+            if (EntryIndex == DefaultKeyMappings->EntryIndicesByMapping.end()) continue;
+
+            const FKeyMappingDefaults::FEntry& Default = DefaultKeyMappings->Entries[EntryIndex->second];
+            if (DefaultKeyMappings->GetActionPathHash(EntryIndex->second) != Entry.ActionPathHash) continue;
+
+            // Skip, if the key is not known anymore
+            const FKey CustomKey{GetSnapshotName(Reader, Entry.CustomKey)};
+            if (!CustomKey.IsValid()) continue;
+
+            // Skip, if the name is outside of the name table or empty, e.g. in a hand-edited snapshot
+            const FName MappingName = GetSnapshotName(Reader, Entry.MappingName);
+            if (MappingName.IsNone()) continue;
+
+            // The mapping name is checked along with the rest of the stored packs
+            FKeyMappingPack Pack{Context->second, Default.MappingAction, Default.DefaultKey, Entry.MappingIndex, MappingName};
+            Pack.CustomKey = CustomKey;
+
+            StoredPacks.Emplace(MoveTemp(Pack));
+        }
+
+        return true;
+    }
+
+    // Only remapped keys are stored, the default ones are taken from the contexts
+    // The changed keys and the path hashes of their entries are copied here, the snapshot is serialized and written by the persister in the background
+    void SaveKeyMappingSnapshot() const
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(URebindSettingController::SaveKeyMappingSnapshot);
+
+        check(SnapshotPersister.IsValid());
+
+        TArray<FKeyMappingSnapshotPersister::FStoredMapping> Mappings;
+        Mappings.Reserve(static_cast<int32>(RebindSettings.CustomKeys.size()));
+
+        for (const auto& [EntryIndex, CustomKey] : RebindSettings.CustomKeys)
+        {
+            const FKeyMappingDefaults::FEntry& Default = DefaultKeyMappings->Entries[EntryIndex];
+
+            FKeyMappingSnapshotPersister::FStoredMapping& Mapping = Mappings.Emplace_GetRef();
+            Mapping.ContextPathHash = Default.ContextPathHash;
+            Mapping.ActionPathHash = DefaultKeyMappings->GetActionPathHash(EntryIndex);
+            Mapping.MappingName = Default.MappingName;
+            Mapping.DefaultKey = Default.DefaultKey.GetFName();
+            Mapping.CustomKey = CustomKey.GetFName();
+            Mapping.MappingIndex = Default.MappingIndex;
+        }
+
+        SnapshotPersister->Enqueue(MoveTemp(Mappings));
     }
 
 ////////////////////////////
@@ -346,6 +738,8 @@ private:
     // Collects loaded and unloaded assets!
     static TArray<UInputMappingContext*> FindAllInputMappingContexts()
     {
+        TRACE_CPUPROFILER_EVENT_SCOPE(URebindSettingController::FindAllInputMappingContexts);
+
         const FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 
         IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
@@ -354,6 +748,9 @@ private:
 
         AssetRegistry.ScanPathsSynchronous({ RootPath }, /*bForceRescan*/ false);
 
+        // Contexts found by the scan above are collected now, the ones added later start a new session
+        WatchForNewInputMappingContexts(AssetRegistry);
+
         FARFilter Filter;
         Filter.bRecursivePaths = true;
         Filter.bRecursiveClasses = true;
@@ -366,17 +763,42 @@ private:
         // Returned array
         TArray<UInputMappingContext*> Result;
 
+        // Unloaded contexts are loaded synchronously by GetAsset, which is the usual cause of hitches here
+        int32 SynchronousLoadCount = 0;
+
         for (const FAssetData& Data : AssetDataArray)
         {
+            if (!Data.IsAssetLoaded()) ++SynchronousLoadCount;
+
             if (UInputMappingContext* IMC = Cast<UInputMappingContext>(Data.GetAsset()))
             {
                 Result.Emplace(IMC);
             }
         }
 
+        SET_DWORD_STAT(STAT_RebindSetting_ContextsLoadedSynchronously, SynchronousLoadCount);
+
         return Result;
     }
 
+    static void WatchForNewInputMappingContexts(IAssetRegistry& AssetRegistry)
+    {
+        static bool bIsWatching = false;
+        if (bIsWatching) return;
+        bIsWatching = true;
+
+        AssetRegistry.OnAssetAdded().AddStatic(&URebindSettingController::OnAssetAdded);
+    }
+
+    // E.g. a mod, mounted with its asset registry, adds its contexts to the project's Content folder
+    static void OnAssetAdded(const FAssetData& Data)
+    {
+        if (Data.AssetClassPath != UInputMappingContext::StaticClass()->GetClassPathName()) return;
+        if (!Data.PackageName.ToString().StartsWith(TEXT("/Game/"))) return;
+
+        StartNewKeyMappingSession();
+    }
+
 ////////////////////////////
 
     // The following functions relate to the custom Furnish Master classes
@@ -384,18 +806,22 @@ private:
     {
         //OnSettingsChange.Broadcast();
         //GetSettingsManager()->SaveSettings();
+
+        // The settings are stored between game sessions only in shipping builds for debug reasons!
+        #if UE_BUILD_SHIPPING
+        SaveKeyMappingSnapshot();
+        #endif // UE_BUILD_SHIPPING
     }
 
 ////////////////////////////
 
-    // This function is not used. In theory, we need to call it after any mapping change.
-    // But everything (including Shipping) works fine without it
-    void RebuildControlMappings() const
+    // Returns nullptr, if the player has no player controller yet or anymore
+    UEnhancedInputLocalPlayerSubsystem* GetEnhancedInputSubsystem() const
     {
-        const APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+        const APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), LocalPlayerIndex);
 
         // This prevents crash, when this function is called at PIE stop
-        if (!static_cast<bool>(PlayerController)) return;
+        if (!static_cast<bool>(PlayerController)) return nullptr;
 
         const ULocalPlayer* LocalPlayer = PlayerController->GetLocalPlayer();
         check(LocalPlayer);
@@ -403,46 +829,154 @@ private:
         UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(LocalPlayer);
         check(Subsystem);
 
+        return Subsystem;
+    }
+
+    // Replaces one context by another one with the same priority, if the player has it
+    static void SwapMappingContext(UEnhancedInputLocalPlayerSubsystem& Subsystem, const UInputMappingContext* From, const UInputMappingContext* To)
+    {
+        int32 Priority = 0;
+        if (!Subsystem.HasMappingContext(From, Priority)) return;
+
+        Subsystem.RemoveMappingContext(From);
+        Subsystem.AddMappingContext(To, Priority);
+    }
+
+    // The player uses the shared contexts again
+    void DropPlayerMappingContexts()
+    {
+        if (UEnhancedInputLocalPlayerSubsystem* Subsystem = GetEnhancedInputSubsystem())
+        {
+            for (const TPair<UInputMappingContext*, UInputMappingContext*>& Pair : PlayerMappingContexts)
+            {
+                SwapMappingContext(*Subsystem, Pair.Value, Pair.Key);
+            }
+        }
+
+        PlayerMappingContexts.Empty();
+    }
+
+    // Brings the copies of this player's contexts in line with the settings: creates, updates or drops them
+    void UpdatePlayerMappingContexts(UEnhancedInputLocalPlayerSubsystem* Subsystem)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(URebindSettingController::UpdatePlayerMappingContexts);
+
+        const std::vector<UInputMappingContext*> RemappedContexts = RebindSettings.GetRemappedContexts();
+
+        // The player uses the shared context again, once all its keys are default
+        for (auto It = PlayerMappingContexts.CreateIterator(); It; ++It)
+        {
+            if (std::find(RemappedContexts.begin(), RemappedContexts.end(), It->Key) != RemappedContexts.end()) continue;
+
+            if (Subsystem) SwapMappingContext(*Subsystem, It->Value, It->Key);
+            It.RemoveCurrent();
+        }
+
+        for (UInputMappingContext* SharedContext : RemappedContexts)
+        {
+            UInputMappingContext*& PlayerContext = PlayerMappingContexts.FindOrAdd(SharedContext);
+
+            // Contexts of different folders may share a name, while their copies share the outer
+            if (!PlayerContext)
+            {
+                const FName CopyName = MakeUniqueObjectName(this, UInputMappingContext::StaticClass(), SharedContext->GetFName());
+                PlayerContext = DuplicateObject<UInputMappingContext>(SharedContext, this, CopyName);
+            }
+
+            RebindSettings.ApplyKeysToPlayerContext(*SharedContext, *PlayerContext);
+
+            if (Subsystem) SwapMappingContext(*Subsystem, SharedContext, PlayerContext);
+        }
+    }
+
+    // Must be called after any mapping change, but it is rather expensive
+    // So it is called once per committed rebind transaction
+    void RebuildControlMappings()
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE(URebindSettingController::RebuildControlMappings);
+
+        UEnhancedInputLocalPlayerSubsystem* Subsystem = GetEnhancedInputSubsystem();
+
+        // The copies are kept up to date even without a player controller, they are swapped in by ApplyPlayerMappingContexts later
+        UpdatePlayerMappingContexts(Subsystem);
+
+        if (!Subsystem) return;
+
         Subsystem->RequestRebuildControlMappings();
     }
 
 ////////////////////////////
 
-    static void UpdateKeyInContextByIndex(UInputMappingContext* MappingContext, const int32 MappingIndex, const FKey& KeyToSet)
+    // Rebuilds the mappings, saves and broadcasts the settings once for any number of changes
+    void CommitRebindChanges()
     {
-        check(MappingContext);
+        if (!RebindSettings.ConsumeUncommittedRebinds()) return;
+
+        RebuildControlMappings();
+        ApplyRebindSettings();
+    }
+
+////////////////////////////
+
+public:
+
+////////////////////////////
 
-        // This pack is invalid, if this check fires
-        check(MappingContext->GetMappings().Num() > MappingIndex);
+    // The game adds the shared contexts to the player's subsystem as usual,
+    // this function must be called after that to replace the contexts remapped by this player with its own copies
+    UFUNCTION(BlueprintCallable, Category = "Rebind Setting")
+    void ApplyPlayerMappingContexts()
+    {
+        RebuildControlMappings();
+    }
 
-        // Restore default key in the respective mapping context
-        FEnhancedActionKeyMapping& MappingToRestore = MappingContext->GetMapping(MappingIndex);
-        MappingToRestore.Key = KeyToSet;
+    // Starts a new session of the shared default mappings, it is called, when the asset registry adds a mapping context
+    // The next RecalculatePlayerMappingSettings collects the defaults anew, so it must be called for every local player after this one
+    UFUNCTION(BlueprintCallable, Category = "Rebind Setting")
+    static void StartNewKeyMappingSession()
+    {
+        ++GetKeyMappingSession();
     }
 
 ////////////////////////////
 
-    void UpdateCustomKeyInPackAndSettings(FKeyMappingPack& PackParam, const FKey& KeyToSet)
+    // Groups remaps and restores made during its lifetime into a single rebind transaction
+    struct FScopedRebindTransaction
     {
-        // Restore default key in the settings
-        for (FKeyMappingPack& StablePack : StableKeyMappingPacks)
+        explicit FScopedRebindTransaction(URebindSettingController& InController) : Controller(InController)
         {
-            if (StablePack != PackParam) continue;
-            StablePack.CustomKey = KeyToSet;
+            Controller.BeginRebindTransaction();
+        }
 
-            break;
+        ~FScopedRebindTransaction()
+        {
+            Controller.EndRebindTransaction();
         }
 
-        // Restore default key in the pack (after settings were changed!)
-        PackParam.CustomKey = KeyToSet;
+        FScopedRebindTransaction(const FScopedRebindTransaction&) = delete;
+        FScopedRebindTransaction& operator=(const FScopedRebindTransaction&) = delete;
 
-        // Save settings immediately after remapping
-        ApplyRebindSettings();
+    private:
+
+        URebindSettingController& Controller;
+    };
+
+    // Until the matching EndRebindTransaction, every change of a key is kept in the settings only:
+    // the player's contexts and mappings are not rebuilt and the settings are neither saved nor broadcast
+    // Transactions may be nested, the changes are committed by the outermost one
+    UFUNCTION(BlueprintCallable, Category = "Rebind Setting")
+    void BeginRebindTransaction()
+    {
+        RebindSettings.BeginRebindTransaction();
     }
 
-////////////////////////////
+    UFUNCTION(BlueprintCallable, Category = "Rebind Setting")
+    void EndRebindTransaction()
+    {
+        RebindSettings.EndRebindTransaction();
 
-public:
+        CommitRebindChanges();
+    }
 
 ////////////////////////////
 
@@ -458,48 +992,139 @@ public:
     UFUNCTION(BlueprintPure, Category = "Rebind Setting")
     void UnpackRebindPack(const FKeyMappingPack& Pack, FText& ActionName, FKey& PackedKey) const
     {
-        check(Pack.CustomKey.IsValid());
-        check(!Pack.MappingDisplayName.IsEmptyOrWhitespace());
-
         PackedKey = Pack.CustomKey;
-        ActionName = Pack.MappingDisplayName;
+
+        // The name alone is not enough: mappings of one name may be displayed differently
+        // Packs, which are unknown to the current defaults, are shown without a name
+        const FText* DisplayName = DefaultKeyMappings.IsValid() ? DefaultKeyMappings->FindMappingDisplayName(Pack) : nullptr;
+        ActionName = DisplayName ? *DisplayName : FText::GetEmpty();
     }
 
 ////////////////////////////
 
+    // Copies every pack of the control mode, prefer the handles below for the UI, which is refreshed often
     UFUNCTION(BlueprintPure=false, Category = "Rebind Setting")
     TArray<FKeyMappingPack> GetMappingPacksForControlMode(const FText& ControlMode) const
     {
-        // This array must never be empty at this point
-        // If it is, most likely we did not mark any input action for remapping
-        check(!StableKeyMappingPacks.IsEmpty());
+        SCOPE_CYCLE_COUNTER(STAT_RebindSetting_GetMappingPacksForControlMode);
+
+        const TConstArrayView<FKeyMappingHandle> Handles = GetMappingPackHandles(ControlMode);
 
         TArray<FKeyMappingPack> ReturnPacks;
+        ReturnPacks.Reserve(Handles.Num());
 
-        for (const FKeyMappingPack& Pack : StableKeyMappingPacks)
+        for (const FKeyMappingHandle Handle : Handles)
         {
-            if (ReturnPacks.Contains(Pack) || !IsCorrectControlMode(Pack, ControlMode)) continue;
-
-            ReturnPacks.Emplace(Pack);
+            ReturnPacks.Emplace(GetMappingPackByHandle(Handle));
         }
 
-        // This array also must never be empty
-        check(!ReturnPacks.IsEmpty());
-
         return ReturnPacks;
     }
 
+////////////////////////////
+
+    // View over the handles of the packs of the control mode, valid until the next change of keys
+    // Nothing is allocated, unless a key has changed since the previous call
+    TConstArrayView<FKeyMappingHandle> GetMappingPackHandles(const FText& ControlMode) const
+    {
+        const std::vector<FKeyMappingHandle>& Handles = RebindSettings.GetMappingPackHandles(ControlMode);
+
+        return TConstArrayView<FKeyMappingHandle>(Handles.data(), static_cast<int32>(Handles.size()));
+    }
+
+    // False for handles of an earlier table, e.g. kept by the UI over a session start
+    UFUNCTION(BlueprintPure, Category = "Rebind Setting")
+    bool IsValidMappingPackHandle(const FKeyMappingHandle& Handle) const
+    {
+        return RebindSettings.IsValidMappingPackHandle(Handle);
+    }
+
+    [[nodiscard]] const FText& GetMappingDisplayName(const FKeyMappingHandle Handle) const
+    {
+        return RebindSettings.GetMappingDisplayName(Handle);
+    }
+
+    [[nodiscard]] const FKey& GetMappingDefaultKey(const FKeyMappingHandle Handle) const
+    {
+        return RebindSettings.GetMappingDefaultKey(Handle);
+    }
+
+    [[nodiscard]] const FKey& GetMappingCustomKey(const FKeyMappingHandle Handle) const
+    {
+        return RebindSettings.GetMappingCustomKey(Handle);
+    }
+
+////////////////////////////
+
+    // Blueprints iterate the handles by index, so no array is copied into the graph
+    UFUNCTION(BlueprintPure, Category = "Rebind Setting")
+    int32 GetNumMappingPackHandles(const FText& ControlMode) const
+    {
+        return GetMappingPackHandles(ControlMode).Num();
+    }
+
+    UFUNCTION(BlueprintPure, Category = "Rebind Setting")
+    FKeyMappingHandle GetMappingPackHandle(const FText& ControlMode, const int32 Index) const
+    {
+        const TConstArrayView<FKeyMappingHandle> Handles = GetMappingPackHandles(ControlMode);
+        check(Handles.IsValidIndex(Index));
+
+        return Handles[Index];
+    }
+
+    UFUNCTION(BlueprintPure, Category = "Rebind Setting")
+    void UnpackMappingPackHandle(const FKeyMappingHandle& Handle, FText& ActionName, FKey& PackedKey, bool& bIsCustomKeySet) const
+    {
+        PackedKey = GetMappingCustomKey(Handle);
+        ActionName = GetMappingDisplayName(Handle);
+        bIsCustomKeySet = PackedKey != GetMappingDefaultKey(Handle);
+    }
+
+    // The pack is made only when it is needed, e.g. to remap its key
+    UFUNCTION(BlueprintPure, Category = "Rebind Setting")
+    FKeyMappingPack GetMappingPackByHandle(const FKeyMappingHandle& Handle) const
+    {
+        FKeyMappingPack Pack = RebindSettings.GetMappingPackByHandle(Handle);
+        Pack.MappingDisplayName = GetMappingDisplayName(Handle);
+        return Pack;
+    }
+
 ////////////////////////////
 
     UFUNCTION(BlueprintPure=false, Category = "Rebind Setting")
     void RemapControlKey(UPARAM(ref) FKeyMappingPack& PackParam, const FKey& KeyToSet)
     {
+        SCOPE_CYCLE_COUNTER(STAT_RebindSetting_RemapControlKey);
+
         // We have nothing to do, if we change no key
         //if (PackParam.CustomKey == KeyToSet) return;
 
-        UpdateKeyInContextByIndex(PackParam.MappingContext, PackParam.MappingIndex, KeyToSet);
+        RebindSettings.RemapControlKey(PackParam, KeyToSet);
+
+        // Outside of a transaction, save settings immediately after remapping
+        CommitRebindChanges();
+    }
+
+////////////////////////////
+
+    // Looks for another pack of the same context and control mode, which already uses the key
+    UFUNCTION(BlueprintPure=false, meta = (ExpandBoolAsExecs = "ReturnValue"), Category = "Rebind Setting")
+    bool FindConflictingPack(const FKeyMappingPack& Pack, const FKey& KeyToSet, FKeyMappingPack& ConflictingPack) const
+    {
+        if (!RebindSettings.FindConflictingPack(Pack, KeyToSet, ConflictingPack)) return false;
+
+        // The conflicting pack is made from the current defaults, so its display name is always found
+        ConflictingPack.MappingDisplayName = *DefaultKeyMappings->FindMappingDisplayName(ConflictingPack);
+        return true;
+    }
+
+    // Remaps the key and, if another pack already uses it, gives that pack the previous key of this one
+    UFUNCTION(BlueprintPure=false, Category = "Rebind Setting")
+    void RemapControlKeyWithSwap(UPARAM(ref) FKeyMappingPack& PackParam, const FKey& KeyToSet)
+    {
+        RebindSettings.RemapControlKeyWithSwap(PackParam, KeyToSet);
 
-        UpdateCustomKeyInPackAndSettings(PackParam, KeyToSet);
+        CommitRebindChanges();
     }
 
 ////////////////////////////
@@ -510,9 +1135,19 @@ public:
         // We have nothing to do, if we change no key
         //if (PackParam.CustomKey == PackParam.DefaultKey) return;
 
-        UpdateKeyInContextByIndex(PackParam.MappingContext, PackParam.MappingIndex, PackParam.DefaultKey);
+        RebindSettings.RestoreDefaultKey(PackParam);
+
+        CommitRebindChanges();
+    }
+
+////////////////////////////
+
+    UFUNCTION(BlueprintPure=false, Category = "Rebind Setting")
+    void RestoreAllDefaultKeys()
+    {
+        RebindSettings.RestoreAllDefaultKeys();
 
-        UpdateCustomKeyInPackAndSettings(PackParam, PackParam.DefaultKey);
+        CommitRebindChanges();
     }
 
 };
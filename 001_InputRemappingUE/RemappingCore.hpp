@@ -0,0 +1,777 @@
+#pragma once
+
+// Engine-independent core of URebindSettingController
+// The controller is built on it and keeps only the glue with the engine: discovery of the contexts, snapshots,
+// the player's own copies of the contexts, rebuild of the player's mappings and the Blueprint API.
+// The benchmarks run the same code with stand-in types
+//
+// The shared contexts are only read: they always have their default keys,
+// the keys of every player are written into its own copies of the contexts it has remapped
+//
+// Types and engine calls are supplied by the traits:
+//
+// struct FTraits
+// {
+//     using FKey, FText, FName, FContext, FAction, FMapping;
+//     using FPack;      // e.g. TKeyMappingPack<FTraits>, made by TRebindSettings only
+//     using FHandle;    // e.g. FEntryHandle, made by TRebindSettings only
+//
+//     static int32_t Num(const FContext&);
+//     static FMapping& GetMapping(FContext&, int32_t Index);
+//     static bool IsPlayerMappable(const FMapping&);
+//     static const FAction* GetAction(const FMapping&);
+//     static const FKey& GetKey(const FMapping&);
+//     static void SetKey(FMapping&, const FKey&);
+//     static bool IsValid(const FKey&);
+//     static bool IsNone(const FName&);
+//     static FName GetMappingName(const FMapping&);
+//     static FText GetMappingDisplayName(const FMapping&);    // see FKeyMappingPack::GetMappingDisplayName
+//     static bool IsEmpty(const FText&);
+//     static bool IsCorrectControlMode(const FKey&, const FText& ControlMode);
+//     static bool IsSameControlMode(const FText&, const FText&);
+//     static size_t GetTypeHash(const FKey&);
+//     static size_t GetTypeHash(const FName&);
+//     static uint64_t GetPathHash(const FContext&);          // hash of the object path, as in the snapshot
+//     static uint64_t GetPathHash(const FAction&);
+// };
+//
+// Checks, trace scopes and counters are routed to the engine by defining these macros before the include:
+// REMAPPING_CORE_CHECK(Expression), REMAPPING_CORE_TRACE_SCOPE(Name),
+// REMAPPING_CORE_SET_COUNTER(Name, Value)
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+#ifndef REMAPPING_CORE_CHECK
+#define REMAPPING_CORE_CHECK(Expression) assert(Expression)
+#endif
+
+#ifndef REMAPPING_CORE_TRACE_SCOPE
+#define REMAPPING_CORE_TRACE_SCOPE(Name)
+#endif
+
+#ifndef REMAPPING_CORE_SET_COUNTER
+#define REMAPPING_CORE_SET_COUNTER(Name, Value)
+#endif
+
+
+namespace RemappingCore
+{
+
+template <typename TTraits>
+struct TKeyMappingPack
+{
+    using FKey = typename TTraits::FKey;
+    using FName = typename TTraits::FName;
+    using FContext = typename TTraits::FContext;
+    using FAction = typename TTraits::FAction;
+
+    FContext* MappingContext = nullptr;
+    const FAction* MappingAction = nullptr;
+    FKey DefaultKey{};
+    FKey CustomKey{};
+    FName MappingName{};
+    int32_t MappingIndex = -1;
+
+    /////////////////////
+
+    TKeyMappingPack() = default;
+
+    TKeyMappingPack(FContext* Context, const FAction* Action, const FKey& KeyToStore, const int32_t KeyIndex, const FName Name) :
+        MappingContext(Context),
+        MappingAction(Action),
+        DefaultKey(KeyToStore),
+        CustomKey(KeyToStore),
+        MappingName(Name),
+        MappingIndex(KeyIndex)
+    {
+        REMAPPING_CORE_CHECK(MappingContext);
+        REMAPPING_CORE_CHECK(MappingAction);
+        REMAPPING_CORE_CHECK(TTraits::IsValid(DefaultKey));
+        REMAPPING_CORE_CHECK(!TTraits::IsNone(MappingName));
+        REMAPPING_CORE_CHECK(KeyIndex >= 0);
+    }
+
+    /////////////////////
+
+    bool operator==(const TKeyMappingPack& Other) const
+    {
+        return true
+        && Other.MappingContext == MappingContext
+        && Other.MappingAction == MappingAction
+        && Other.CustomKey == CustomKey
+        && Other.MappingName == MappingName
+        && Other.MappingIndex == MappingIndex;
+    }
+
+    bool operator!=(const TKeyMappingPack& Other) const
+    {
+        return !(*this == Other);
+    }
+};
+
+// Light reference to a pack: the index of its default entry and the generation of the table it indexes
+struct FEntryHandle
+{
+    FEntryHandle() = default;
+
+    FEntryHandle(const int32_t InEntryIndex, const uint32_t InGeneration) : EntryIndex(InEntryIndex), Generation(InGeneration)
+    {
+    }
+
+    int32_t EntryIndex = -1;
+    uint32_t Generation = 0;
+};
+
+
+//////////////////////////////////////////
+
+
+// Hash of a pair of a context and either a mapping index or a key
+template <typename TTraits>
+struct THashContextPair
+{
+    template <typename TFirst, typename TSecond>
+    size_t operator()(const std::pair<TFirst, TSecond>& Pair) const
+    {
+        return std::hash<TFirst>{}(Pair.first) ^ (GetSecondHash(Pair.second) * 0x9E3779B97F4A7C15ull);
+    }
+
+private:
+
+    static size_t GetSecondHash(const int32_t Index) { return static_cast<size_t>(Index); }
+
+    template <typename TSecond>
+    static size_t GetSecondHash(const TSecond& Second) { return TTraits::GetTypeHash(Second); }
+};
+
+
+// Default key mappings of all contexts, collected once per session and shared by all local players
+// It is never changed after being built: every player keeps only the keys remapped on top of it
+template <typename TTraits>
+struct TKeyMappingDefaults
+{
+    using FPack = typename TTraits::FPack;
+    using FKey = typename TTraits::FKey;
+    using FText = typename TTraits::FText;
+    using FName = typename TTraits::FName;
+    using FContext = typename TTraits::FContext;
+    using FAction = typename TTraits::FAction;
+    using FMapping = typename TTraits::FMapping;
+
+    struct FEntry
+    {
+        FContext* MappingContext = nullptr;
+        const FAction* MappingAction = nullptr;
+        FKey DefaultKey{};
+        FName MappingName{};
+        int32_t MappingIndex = -1;
+
+        // Resolved once per mapping: mappings of one name may have different custom display names
+        FText DisplayName{};
+
+        // Hash of the context's object path, taken once per session, so neither the snapshot's load nor its save builds it
+        // Actions are many more than contexts, their hashes are taken only for the entries the snapshot touches, see GetActionPathHash
+        uint64_t ContextPathHash = 0;
+    };
+
+    using FContextKeyPair = std::pair<const FContext*, FKey>;
+    using FContextIndexPair = std::pair<const FContext*, int32_t>;
+
+    std::vector<FEntry> Entries;
+
+    // Contexts with mappable keys, by the hashes of their object paths too
+    std::vector<FContext*> Contexts;
+    std::unordered_map<uint64_t, FContext*> ContextsByPathHash;
+
+    // Indices of Entries by their context and mapping index, and by their context and default key
+    std::unordered_map<FContextIndexPair, int32_t, THashContextPair<TTraits>> EntryIndicesByMapping;
+    std::unordered_map<FContextKeyPair, std::vector<int32_t>, THashContextPair<TTraits>> EntryIndicesByDefaultKey;
+
+    // Entries of one context are collected one after another: the first one and the one past the last by their context
+    std::unordered_map<const FContext*, std::pair<int32_t, int32_t>> EntryRangesByContext;
+
+    // Hashes of the action paths taken so far, filled on the game thread only
+    mutable std::unordered_map<const FAction*, uint64_t> ActionPathHashes;
+
+    // Differs between all tables of the process, so a handle never indexes a table it was not made from
+    uint32_t Generation = 0;
+
+    /////////////////////
+
+    // Must be called once
+    template <typename TContexts>
+    void Collect(const TContexts& AllContexts)
+    {
+        REMAPPING_CORE_TRACE_SCOPE(RemappingCore::CollectDefaultKeyMappings);
+
+        // Zero is left to default constructed handles
+        static uint32_t LastGeneration = 0;
+        Generation = ++LastGeneration;
+
+        CollectContextsWithMappableKeys(AllContexts);
+        CollectNewControlSettings();
+    }
+
+    // Searches for the default mapping, with identical context, index, name and action
+    // Returns its index or -1, if the pack is deemed invalid
+    int32_t FindSimilarMapping(const FPack& Pack) const
+    {
+        const auto Found = EntryIndicesByMapping.find({Pack.MappingContext, Pack.MappingIndex});
+
+        // The context has changed or has no mappable mapping under this number
+        if (Found == EntryIndicesByMapping.end()) return -1;
+
+        // If the action or the name of the mapping are different, this pack is deemed invalid
+        const FEntry& Entry = Entries[Found->second];
+        const bool bIsPackValid = true
+            && Entry.MappingAction == Pack.MappingAction
+            && Entry.MappingName == Pack.MappingName;
+
+        return bIsPackValid ? Found->second : -1;
+    }
+
+    // The path of every action is built and hashed once, when the first entry of the action is saved or loaded
+    uint64_t GetActionPathHash(const int32_t EntryIndex) const
+    {
+        const FAction* Action = Entries[EntryIndex].MappingAction;
+
+        auto Found = ActionPathHashes.find(Action);
+        if (Found == ActionPathHashes.end())
+        {
+            Found = ActionPathHashes.emplace(Action, TTraits::GetPathHash(*Action)).first;
+        }
+
+        return Found->second;
+    }
+
+    // Returns nullptr, if the pack is deemed invalid, e.g. made by a Blueprint or kept over a session start
+    const FText* FindMappingDisplayName(const FPack& Pack) const
+    {
+        const int32_t EntryIndex = FindSimilarMapping(Pack);
+        return EntryIndex >= 0 ? &Entries[EntryIndex].DisplayName : nullptr;
+    }
+
+private:
+
+    template <typename TContexts>
+    void CollectContextsWithMappableKeys(const TContexts& AllContexts)
+    {
+        REMAPPING_CORE_TRACE_SCOPE(RemappingCore::CollectContextsWithMappableKeys);
+
+        int32_t ContextCount = 0;
+
+        for (FContext* OneContext : AllContexts)
+        {
+            ++ContextCount;
+
+            for (int32_t Index = 0; Index < TTraits::Num(*OneContext); ++Index)
+            {
+                // Skip, if this mapping is not editable
+                if (!TTraits::IsPlayerMappable(TTraits::GetMapping(*OneContext, Index))) continue;
+
+                // One mappable mapping is enough for the context to be collected
+                Contexts.emplace_back(OneContext);
+                break;
+            }
+        }
+
+        REMAPPING_CORE_SET_COUNTER(ContextsScanned, ContextCount);
+
+        // Packs are formed from the contexts, so something went wrong, if no context had at least one mappable mapping
+        REMAPPING_CORE_CHECK(ContextCount > 0);
+        REMAPPING_CORE_CHECK(!Contexts.empty());
+    }
+
+    void CollectNewControlSettings()
+    {
+        REMAPPING_CORE_TRACE_SCOPE(RemappingCore::CollectNewControlSettings);
+
+        for (FContext* OneContext : Contexts)
+        {
+            const uint64_t ContextPathHash = TTraits::GetPathHash(*OneContext);
+            ContextsByPathHash.emplace(ContextPathHash, OneContext);
+
+            const int32_t FirstEntryIndex = static_cast<int32_t>(Entries.size());
+
+            for (int32_t KeyIndex = 0; KeyIndex < TTraits::Num(*OneContext); ++KeyIndex)
+            {
+                const FMapping& OneMapping = TTraits::GetMapping(*OneContext, KeyIndex);
+
+                // Skip, if this mapping is not editable
+                if (!TTraits::IsPlayerMappable(OneMapping)) continue;
+
+                const FName MappingName = TTraits::GetMappingName(OneMapping);
+                REMAPPING_CORE_CHECK(!TTraits::IsNone(MappingName));
+
+                // Mappings of one name may have different display names, so it is resolved per mapping
+                FText DisplayName = TTraits::GetMappingDisplayName(OneMapping);
+                REMAPPING_CORE_CHECK(!TTraits::IsEmpty(DisplayName));
+
+                const FAction* OneAction = TTraits::GetAction(OneMapping);
+                REMAPPING_CORE_CHECK(OneAction);
+
+                const FKey& DefaultKey = TTraits::GetKey(OneMapping);
+                REMAPPING_CORE_CHECK(TTraits::IsValid(DefaultKey));
+
+                const int32_t EntryIndex = static_cast<int32_t>(Entries.size());
+                Entries.push_back(FEntry{OneContext, OneAction, DefaultKey, MappingName, KeyIndex, std::move(DisplayName), ContextPathHash});
+                EntryIndicesByMapping.emplace(FContextIndexPair{OneContext, KeyIndex}, EntryIndex);
+                EntryIndicesByDefaultKey[{OneContext, DefaultKey}].emplace_back(EntryIndex);
+            }
+
+            EntryRangesByContext.emplace(OneContext, std::make_pair(FirstEntryIndex, static_cast<int32_t>(Entries.size())));
+        }
+    }
+};
+
+
+//////////////////////////////////////////
+
+
+// Settings of one local player: a sparse overlay of custom keys on top of the shared defaults
+// The defaults are owned by the caller and must outlive the settings, until they are recalculated
+// The settings never write into the shared contexts, the caller applies them to the player's own copies
+template <typename TTraits>
+class TRebindSettings
+{
+public:
+
+    using FDefaults = TKeyMappingDefaults<TTraits>;
+    using FEntry = typename FDefaults::FEntry;
+    using FPack = typename TTraits::FPack;
+    using FHandle = typename TTraits::FHandle;
+    using FKey = typename TTraits::FKey;
+    using FText = typename TTraits::FText;
+    using FContext = typename TTraits::FContext;
+
+    const FDefaults* DefaultKeyMappings = nullptr;
+
+    // Keys, which differ from the defaults, by the index of their default entry
+    std::unordered_map<int32_t, FKey> CustomKeys;
+
+    // Indices of remapped entries by their context and custom key
+    // Entries with default keys are found through the shared table
+    // The control mode is defined by the key, so entries of one bucket always share it
+    std::unordered_map<typename FDefaults::FContextKeyPair, std::vector<int32_t>, THashContextPair<TTraits>> EntryIndicesByCustomKey;
+
+    /////////////////////
+
+    // Must be called once at the start of every game session
+    // Restores valid stored keys into the settings and drops obsolete ones
+    template <typename TPacks>
+    void RecalculatePlayerMappingSettings(const FDefaults& Defaults, const TPacks& StoredPacks)
+    {
+        REMAPPING_CORE_TRACE_SCOPE(RemappingCore::RecalculatePlayerMappingSettings);
+
+        DefaultKeyMappings = &Defaults;
+
+        CustomKeys.clear();
+        EntryIndicesByCustomKey.clear();
+        ++CustomKeysRevision;
+
+        RestoreStoredKeysAndRemoveObsoleteMappings(StoredPacks);
+    }
+
+    // Packs, which are saved between game sessions
+    std::vector<FPack> GetStoredPacks() const
+    {
+        std::vector<FPack> StoredPacks;
+        StoredPacks.reserve(CustomKeys.size());
+
+        for (const auto& [EntryIndex, CustomKey] : CustomKeys)
+        {
+            StoredPacks.emplace_back(MakePack(EntryIndex));
+        }
+
+        return StoredPacks;
+    }
+
+    /////////////////////
+
+    FKey GetCustomKey(const int32_t EntryIndex) const
+    {
+        const auto Found = CustomKeys.find(EntryIndex);
+        return Found != CustomKeys.end() ? Found->second : DefaultKeyMappings->Entries[EntryIndex].DefaultKey;
+    }
+
+    FPack MakePack(const int32_t EntryIndex) const
+    {
+        const FEntry& Entry = DefaultKeyMappings->Entries[EntryIndex];
+
+        FPack Pack{Entry.MappingContext, Entry.MappingAction, Entry.DefaultKey, Entry.MappingIndex, Entry.MappingName};
+        Pack.CustomKey = GetCustomKey(EntryIndex);
+        return Pack;
+    }
+
+    // Returns the index of another entry of the same context, which already uses the key, or -1
+    int32_t FindConflictingEntryIndex(const int32_t EntryIndex, const FKey& Key) const
+    {
+        const typename FDefaults::FContextKeyPair Pair{DefaultKeyMappings->Entries[EntryIndex].MappingContext, Key};
+
+        // Remapped entries
+        const auto Remapped = EntryIndicesByCustomKey.find(Pair);
+        if (Remapped != EntryIndicesByCustomKey.end())
+        {
+            for (const int32_t OtherIndex : Remapped->second)
+            {
+                if (OtherIndex != EntryIndex) return OtherIndex;
+            }
+        }
+
+        // Entries, which still have their default keys
+        const auto Defaults = DefaultKeyMappings->EntryIndicesByDefaultKey.find(Pair);
+        if (Defaults != DefaultKeyMappings->EntryIndicesByDefaultKey.end())
+        {
+            for (const int32_t OtherIndex : Defaults->second)
+            {
+                if (OtherIndex != EntryIndex && CustomKeys.find(OtherIndex) == CustomKeys.end()) return OtherIndex;
+            }
+        }
+
+        return -1;
+    }
+
+    // Looks for another pack of the same context and control mode, which already uses the key
+    bool FindConflictingPack(const FPack& Pack, const FKey& KeyToSet, FPack& ConflictingPack) const
+    {
+        const int32_t EntryIndex = DefaultKeyMappings->FindSimilarMapping(Pack);
+        if (EntryIndex < 0) return false;
+
+        const int32_t ConflictingEntryIndex = FindConflictingEntryIndex(EntryIndex, KeyToSet);
+        if (ConflictingEntryIndex < 0) return false;
+
+        ConflictingPack = MakePack(ConflictingEntryIndex);
+        return true;
+    }
+
+    /////////////////////
+
+    // Contexts, in which this player has at least one key, which differs from the default one
+    // Only these need a copy of their own for the player, the others are used as they are
+    std::vector<FContext*> GetRemappedContexts() const
+    {
+        std::vector<FContext*> RemappedContexts;
+        RemappedContexts.reserve(CustomKeys.size());
+
+        for (const auto& [EntryIndex, CustomKey] : CustomKeys)
+        {
+            RemappedContexts.emplace_back(DefaultKeyMappings->Entries[EntryIndex].MappingContext);
+        }
+
+        // Many keys of one context may be remapped
+        std::sort(RemappedContexts.begin(), RemappedContexts.end());
+        RemappedContexts.erase(std::unique(RemappedContexts.begin(), RemappedContexts.end()), RemappedContexts.end());
+
+        return RemappedContexts;
+    }
+
+    // Writes the keys of this player into its copy of the shared context
+    // The copy has the mappings of the shared context under the same indices
+    void ApplyKeysToPlayerContext(const FContext& SharedContext, FContext& PlayerContext) const
+    {
+        REMAPPING_CORE_CHECK(TTraits::Num(PlayerContext) == TTraits::Num(SharedContext));
+
+        const auto Range = DefaultKeyMappings->EntryRangesByContext.find(&SharedContext);
+        if (Range == DefaultKeyMappings->EntryRangesByContext.end()) return;
+
+        for (int32_t EntryIndex = Range->second.first; EntryIndex < Range->second.second; ++EntryIndex)
+        {
+            const int32_t MappingIndex = DefaultKeyMappings->Entries[EntryIndex].MappingIndex;
+            TTraits::SetKey(TTraits::GetMapping(PlayerContext, MappingIndex), GetCustomKey(EntryIndex));
+        }
+    }
+
+    /////////////////////
+
+    // Copies every pack of the control mode
+    std::vector<FPack> GetMappingPacksForControlMode(const FText& ControlMode) const
+    {
+        const std::vector<FHandle>& Handles = GetMappingPackHandles(ControlMode);
+
+        std::vector<FPack> ReturnPacks;
+        ReturnPacks.reserve(Handles.size());
+
+        for (const FHandle& Handle : Handles)
+        {
+            ReturnPacks.emplace_back(MakePack(Handle.EntryIndex));
+        }
+
+        return ReturnPacks;
+    }
+
+    // Handles of the packs of the control mode, valid until the next change of keys
+    // Nothing is allocated, unless a key has changed since the previous call
+    const std::vector<FHandle>& GetMappingPackHandles(const FText& ControlMode) const
+    {
+        // This array must never be empty at this point
+        // If it is, most likely we did not mark any input action for remapping
+        REMAPPING_CORE_CHECK(DefaultKeyMappings && !DefaultKeyMappings->Entries.empty());
+
+        auto Cached = std::find_if(HandlesByControlMode.begin(), HandlesByControlMode.end(), [&ControlMode](const FControlModeHandles& Handles)
+        {
+            return TTraits::IsSameControlMode(Handles.ControlMode, ControlMode);
+        });
+        if (Cached == HandlesByControlMode.end())
+        {
+            Cached = HandlesByControlMode.emplace(HandlesByControlMode.end(), ControlMode);
+        }
+
+        if (Cached->CustomKeysRevision == CustomKeysRevision) return Cached->Handles;
+
+        Cached->Handles.clear();
+
+        for (int32_t EntryIndex = 0; EntryIndex < static_cast<int32_t>(DefaultKeyMappings->Entries.size()); ++EntryIndex)
+        {
+            if (!TTraits::IsCorrectControlMode(GetCustomKey(EntryIndex), ControlMode)) continue;
+
+            Cached->Handles.emplace_back(FHandle{EntryIndex, DefaultKeyMappings->Generation});
+        }
+
+        // This array also must never be empty
+        REMAPPING_CORE_CHECK(!Cached->Handles.empty());
+
+        Cached->CustomKeysRevision = CustomKeysRevision;
+        return Cached->Handles;
+    }
+
+    // Whether the handle was made from the current defaults, a handle of an earlier table may index another entry
+    bool IsValidMappingPackHandle(const FHandle& Handle) const
+    {
+        return true
+            && DefaultKeyMappings
+            && Handle.Generation == DefaultKeyMappings->Generation
+            && Handle.EntryIndex >= 0
+            && Handle.EntryIndex < static_cast<int32_t>(DefaultKeyMappings->Entries.size());
+    }
+
+    const FText& GetMappingDisplayName(const FHandle& Handle) const
+    {
+        return GetEntry(Handle).DisplayName;
+    }
+
+    const FKey& GetMappingDefaultKey(const FHandle& Handle) const
+    {
+        return GetEntry(Handle).DefaultKey;
+    }
+
+    const FKey& GetMappingCustomKey(const FHandle& Handle) const
+    {
+        const FEntry& Entry = GetEntry(Handle);
+
+        const auto Found = CustomKeys.find(Handle.EntryIndex);
+        return Found != CustomKeys.end() ? Found->second : Entry.DefaultKey;
+    }
+
+    // The pack is made only when it is needed, e.g. to remap its key
+    FPack GetMappingPackByHandle(const FHandle& Handle) const
+    {
+        REMAPPING_CORE_CHECK(IsValidMappingPackHandle(Handle));
+
+        return MakePack(Handle.EntryIndex);
+    }
+
+    /////////////////////
+
+    // Changes the key in the settings only, it gets into the player's context, when the outermost transaction is committed
+    void RemapControlKey(FPack& PackParam, const FKey& KeyToSet)
+    {
+        UpdateCustomKeyInPackAndSettings(PackParam, KeyToSet);
+    }
+
+    // Remaps the key and, if another pack already uses it, gives that pack the previous key of this one
+    void RemapControlKeyWithSwap(FPack& PackParam, const FKey& KeyToSet)
+    {
+        BeginRebindTransaction();
+
+        const int32_t EntryIndex = DefaultKeyMappings->FindSimilarMapping(PackParam);
+
+        // This pack is invalid, if this check fires
+        REMAPPING_CORE_CHECK(EntryIndex >= 0);
+
+        // The caller's pack may be stale, the settings know the key the mapping has now
+        const FKey PreviousKey = GetCustomKey(EntryIndex);
+
+        FPack ConflictingPack;
+        const bool bHasConflict = FindConflictingPack(PackParam, KeyToSet, ConflictingPack);
+
+        RemapControlKey(PackParam, KeyToSet);
+
+        if (bHasConflict)
+        {
+            RemapControlKey(ConflictingPack, PreviousKey);
+        }
+
+        EndRebindTransaction();
+    }
+
+    void RestoreDefaultKey(FPack& PackParam)
+    {
+        UpdateCustomKeyInPackAndSettings(PackParam, PackParam.DefaultKey);
+    }
+
+    void RestoreAllDefaultKeys()
+    {
+        BeginRebindTransaction();
+
+        // Only remapped entries differ from the defaults
+        std::vector<int32_t> RemappedEntryIndices;
+        RemappedEntryIndices.reserve(CustomKeys.size());
+        for (const auto& [EntryIndex, CustomKey] : CustomKeys)
+        {
+            RemappedEntryIndices.emplace_back(EntryIndex);
+        }
+
+        for (const int32_t EntryIndex : RemappedEntryIndices)
+        {
+            FPack OnePack = MakePack(EntryIndex);
+            RestoreDefaultKey(OnePack);
+        }
+
+        EndRebindTransaction();
+    }
+
+    /////////////////////
+
+    // Changes made inside of a rebind transaction are committed once, when the outermost transaction ends
+    void BeginRebindTransaction()
+    {
+        ++RebindTransactionDepth;
+    }
+
+    void EndRebindTransaction()
+    {
+        // Every EndRebindTransaction must have its BeginRebindTransaction
+        REMAPPING_CORE_CHECK(RebindTransactionDepth > 0);
+
+        --RebindTransactionDepth;
+    }
+
+    // Returns true once for every batch of changes, which must be committed now, i.e. outside of any transaction
+    bool ConsumeUncommittedRebinds()
+    {
+        if (RebindTransactionDepth > 0 || !bHasUncommittedRebinds) return false;
+
+        bHasUncommittedRebinds = false;
+        return true;
+    }
+
+private:
+
+    const FEntry& GetEntry(const FHandle& Handle) const
+    {
+        REMAPPING_CORE_CHECK(IsValidMappingPackHandle(Handle));
+
+        return DefaultKeyMappings->Entries[Handle.EntryIndex];
+    }
+
+    template <typename TPacks>
+    void RestoreStoredKeysAndRemoveObsoleteMappings(const TPacks& StoredPacks)
+    {
+        REMAPPING_CORE_TRACE_SCOPE(RemappingCore::RestoreStoredKeysAndRemoveObsoleteMappings);
+
+        int32_t ValidatedCount = 0;
+        int32_t DroppedCount = 0;
+
+        for (const FPack& OneStablePack : StoredPacks)
+        {
+            ++ValidatedCount;
+
+            // Every stored pack looks for a default mapping with similar name and input action
+            const int32_t EntryIndex = DefaultKeyMappings->FindSimilarMapping(OneStablePack);
+
+            // This pack lost its respective mapping and is dropped
+            if (EntryIndex < 0)
+            {
+                ++DroppedCount;
+                continue;
+            }
+
+            // This pack has proved to be still valid and must persist for this game session
+            SetCustomKey(EntryIndex, OneStablePack.CustomKey);
+        }
+
+        // Every stored pack is looked up exactly once
+        REMAPPING_CORE_SET_COUNTER(PacksValidated, ValidatedCount);
+        REMAPPING_CORE_SET_COUNTER(PacksDropped, DroppedCount);
+        REMAPPING_CORE_SET_COUNTER(SimilarMappingLookups, ValidatedCount);
+    }
+
+    // Only keys, which differ from the defaults, take place in the settings
+    void SetCustomKey(const int32_t EntryIndex, const FKey& KeyToSet)
+    {
+        const FEntry& Entry = DefaultKeyMappings->Entries[EntryIndex];
+
+        // The control mode of the entry may change with its key
+        ++CustomKeysRevision;
+
+        // Remove the entry from the bucket of its previous custom key
+        const auto PreviousKey = CustomKeys.find(EntryIndex);
+        if (PreviousKey != CustomKeys.end())
+        {
+            const auto Bucket = EntryIndicesByCustomKey.find({Entry.MappingContext, PreviousKey->second});
+            if (Bucket != EntryIndicesByCustomKey.end())
+            {
+                std::vector<int32_t>& EntryIndices = Bucket->second;
+                EntryIndices.erase(std::remove(EntryIndices.begin(), EntryIndices.end(), EntryIndex), EntryIndices.end());
+                if (EntryIndices.empty()) EntryIndicesByCustomKey.erase(Bucket);
+            }
+        }
+
+        if (KeyToSet == Entry.DefaultKey)
+        {
+            CustomKeys.erase(EntryIndex);
+            return;
+        }
+
+        CustomKeys[EntryIndex] = KeyToSet;
+        EntryIndicesByCustomKey[{Entry.MappingContext, KeyToSet}].emplace_back(EntryIndex);
+    }
+
+    void UpdateCustomKeyInPackAndSettings(FPack& PackParam, const FKey& KeyToSet)
+    {
+        const int32_t EntryIndex = DefaultKeyMappings->FindSimilarMapping(PackParam);
+
+        // This pack is invalid, if this check fires
+        REMAPPING_CORE_CHECK(EntryIndex >= 0);
+
+        SetCustomKey(EntryIndex, KeyToSet);
+
+        // Update the key in the pack (after settings were changed!)
+        PackParam.CustomKey = KeyToSet;
+
+        bHasUncommittedRebinds = true;
+    }
+
+    /////////////////////
+
+    // Handles of the packs by control mode, rebuilt only after the custom keys have changed
+    // Their arrays are reused, so the UI refreshing the settings allocates nothing
+    struct FControlModeHandles
+    {
+        explicit FControlModeHandles(const FText& InControlMode) : ControlMode(InControlMode)
+        {
+        }
+
+        FText ControlMode;
+        uint32_t CustomKeysRevision = 0;
+        std::vector<FHandle> Handles;
+    };
+
+    mutable std::vector<FControlModeHandles> HandlesByControlMode;
+
+    // Changes with every change of the custom keys; starts above zero, so new cached handles are always stale
+    uint32_t CustomKeysRevision = 1;
+
+    int32_t RebindTransactionDepth = 0;
+    bool bHasUncommittedRebinds = false;
+};
+
+} // namespace RemappingCore
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+# Compiles every TU of every Way and records peak RSS and CPU time of the compiler per TU,
+# then reports how many compilations fit into the given amounts of RAM at once
+# and, with --budget, builds everything again scheduling the jobs by memory instead of a fixed -j$(nproc).
+#
+# Peak RSS comes from wait4() on the g++ process: Linux reports the maximum over the whole process tree,
+# so it is the RSS of cc1plus (or of cc1plus reading/writing the module CMI for Way5).
+#
+# Usage: Tools/BuildMemoryDriver.py [--copies N] [--ram GB ...] [--budget GB] [--jobs N] [Way...]
+
+import argparse
+import os
+import shutil
+import sys
+import tempfile
+import time
+
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.dirname(TOOLS_DIR)
+
+CXX = os.environ.get("CXX", "g++")
+CXXFLAGS = os.environ.get("CXXFLAGS", "-O2").split()
+
+# Flags of every Way, as the article builds it
+WAY_FLAGS = {
+    "Way4_ExplicitInstantiations": ["-fno-implicit-templates"],
+    "Way5_Modules": ["-std=c++20", "-fmodules-ts", "-fno-implicit-templates"],
+}
+
+
+class Job:
+    def __init__(self, way, stage, name, args):
+        self.way = way
+        self.stage = stage
+        self.name = name
+        self.args = args
+        self.peak_rss_kib = 0
+        self.cpu_seconds = 0.0
+        self.wall_seconds = 0.0
+
+
+def make_jobs(way, build_dir, copies):
+    """Jobs of one Way in the order of their stages: a job starts only after every job of the previous stages"""
+    flags = [CXX] + CXXFLAGS + WAY_FLAGS.get(way, [])
+    sources = sorted(f for f in os.listdir(build_dir) if f.endswith(".cpp"))
+    modules = sorted(f for f in os.listdir(build_dir) if f.endswith(".cppm"))
+
+    jobs = []
+    stage = 0
+
+    # Way5 needs the header unit of stdio.h and the module interface before its other TUs
+    if modules:
+        jobs.append(Job(way, stage, "stdio.h", flags + ["-x", "c++-system-header", "stdio.h"]))
+        stage += 1
+        for module in modules:
+            # Older g++ does not know .cppm, so the language is given explicitly
+            jobs.append(Job(way, stage, module, flags + ["-x", "c++", "-c", module]))
+        stage += 1
+
+    # Copies stand for a bigger project made of the same TUs
+    for copy in range(copies):
+        for source in sources:
+            object_name = source[:-len(".cpp")] + (f".{copy}" if copies > 1 else "") + ".o"
+            name = source if copies == 1 else f"{source}#{copy}"
+            jobs.append(Job(way, stage, name, flags + ["-c", source, "-o", object_name]))
+
+    return jobs
+
+
+def spawn(job, cwd):
+    # posix_spawn has no working directory before Python 3.13, so the fork is done by hand
+    pid = os.fork()
+    if pid == 0:
+        try:
+            os.chdir(cwd)
+            os.execvp(job.args[0], job.args)
+        finally:
+            os._exit(127)
+    return pid
+
+
+def run(jobs, build_dirs, max_jobs, budget_kib=None):
+    """Runs the jobs, at most max_jobs and, with a budget, at most budget_kib of estimated RSS at once
+    Returns the wall time, the highest number of jobs and the highest estimated RSS seen running together"""
+    pending = list(jobs)
+    running = {}
+    done_by_stage = {}
+    total_by_stage = {}
+    for job in jobs:
+        total_by_stage[(job.way, job.stage)] = total_by_stage.get((job.way, job.stage), 0) + 1
+
+    def is_ready(job):
+        return all(done_by_stage.get((job.way, stage), 0) == total_by_stage[(job.way, stage)]
+                   for stage in range(job.stage))
+
+    def estimated(job):
+        return job.peak_rss_kib
+
+    max_running = 0
+    max_running_kib = 0
+    start = time.monotonic()
+
+    while pending or running:
+        running_kib = sum(estimated(job) for job, _ in running.values())
+
+        # The biggest ready job, which fits, goes first; one job always runs, even if it alone exceeds the budget
+        ready = sorted((job for job in pending if is_ready(job)), key=estimated, reverse=True)
+        for job in ready:
+            if len(running) >= max_jobs:
+                break
+            if budget_kib is not None and running and running_kib + estimated(job) > budget_kib:
+                continue
+            pending.remove(job)
+            running[spawn(job, build_dirs[job.way])] = (job, time.monotonic())
+            running_kib += estimated(job)
+
+        max_running = max(max_running, len(running))
+        max_running_kib = max(max_running_kib, running_kib)
+
+        pid, status, usage = os.wait4(-1, 0)
+        job, job_start = running.pop(pid)
+        if os.waitstatus_to_exitcode(status) != 0:
+            sys.exit(f"{job.way}/{job.name}: {' '.join(job.args)} failed")
+
+        job.wall_seconds = time.monotonic() - job_start
+        # Only a serial run measures the jobs, parallel ones would only blur the numbers
+        if budget_kib is None and max_jobs == 1:
+            job.peak_rss_kib = usage.ru_maxrss
+            job.cpu_seconds = usage.ru_utime + usage.ru_stime
+
+        done_by_stage[(job.way, job.stage)] = done_by_stage.get((job.way, job.stage), 0) + 1
+
+    return time.monotonic() - start, max_running, max_running_kib
+
+
+def max_parallelism(jobs, ram_kib):
+    """The number of compilations, which fit into the RAM even if all of them are the biggest one
+    It is not limited by the number of TUs, as a real project has many more TUs like these"""
+    return int(ram_kib // max(job.peak_rss_kib for job in jobs))
+
+
+def mib(kib):
+    return f"{kib / 1024:.1f}"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measures peak compiler RSS per TU and schedules the build by memory")
+    parser.add_argument("ways", nargs="*", help="Way directories, all of them by default")
+    parser.add_argument("--copies", type=int, default=1, help="compile every TU this many times")
+    parser.add_argument("--ram", type=float, nargs="+", default=[1, 2, 4, 8, 16], help="RAM sizes in GB to report for")
+    parser.add_argument("--budget", type=float, help="memory budget in GB of the scheduled build")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="maximal number of jobs of the scheduled build")
+    args = parser.parse_args()
+
+    ways = [way.rstrip("/") for way in args.ways] or sorted(
+        entry for entry in os.listdir(ROOT_DIR) if entry.startswith("Way") and os.path.isdir(os.path.join(ROOT_DIR, entry)))
+
+    temp_dir = tempfile.mkdtemp()
+    try:
+        build_dirs = {}
+        jobs = []
+        for way in ways:
+            build_dirs[way] = os.path.join(temp_dir, os.path.basename(way))
+            shutil.copytree(os.path.join(ROOT_DIR, way), build_dirs[way])
+            jobs += make_jobs(way, build_dirs[way], args.copies)
+
+        # Measuring pass: one compilation at a time
+        serial_seconds, _, _ = run(jobs, build_dirs, max_jobs=1)
+
+        print(f"{'Way':<30} {'TU':<24} {'PeakRSS,MiB':>12} {'CPU,s':>8}")
+        for job in jobs:
+            print(f"{job.way:<30} {job.name:<24} {mib(job.peak_rss_kib):>12} {job.cpu_seconds:>8.2f}")
+
+        print()
+        print(f"{'Way':<30} {'TUs':>5} {'MaxRSS,MiB':>11} {'CPU,s':>8}" + "".join(f" {f'j@{ram:g}GB':>8}" for ram in args.ram))
+        for way in ways + ["All"]:
+            way_jobs = [job for job in jobs if way in ("All", job.way)]
+            print(f"{way:<30} {len(way_jobs):>5} {mib(max(job.peak_rss_kib for job in way_jobs)):>11} "
+                  f"{sum(job.cpu_seconds for job in way_jobs):>8.2f}"
+                  + "".join(f" {max_parallelism(way_jobs, ram * 1024 * 1024):>8}" for ram in args.ram))
+
+        print(f"\nSerial build: {serial_seconds:.2f} s")
+
+        if args.budget is not None:
+            for build_dir in build_dirs.values():
+                for entry in os.listdir(build_dir):
+                    if entry.endswith(".o"):
+                        os.remove(os.path.join(build_dir, entry))
+
+            budget_kib = args.budget * 1024 * 1024
+            seconds, max_running, max_running_kib = run(jobs, build_dirs, args.jobs, budget_kib)
+            print(f"Scheduled build within {args.budget:g} GB and {args.jobs} jobs: {seconds:.2f} s, "
+                  f"up to {max_running} jobs and {mib(max_running_kib)} MiB of estimated RSS at once")
+    finally:
+        shutil.rmtree(temp_dir)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,91 @@
+#!/usr/bin/env bash
+# Builds the explicit instantiation TUs of a Way as a shared library and compares it with the static build:
+#   static  - every TU is linked into main, as the article does
+#   default - TemplateUnit*.cpp form libTemplateUnit.so with default visibility
+#   hidden  - the same with -fvisibility=hidden, only SimpleClass and the explicit instantiations are exported (SharedLibraryExport.hpp)
+# Reported: defined dynamic symbols of the library, dynamic relocations (all and PLT slots) of the library and main,
+# relocations and startup time of the dynamic loader (LD_DEBUG=statistics, the best of several runs)
+# and the time of one call of an instantiation, which does nothing (SharedLibraryCallTarget.cpp, built into the library):
+#   ns/MainToLib - an exported instantiation, called from main: through the PLT in both shared modes
+#   ns/LibToLib  - an instantiation internal to the library, called from inside of it:
+#                  through the PLT with default visibility, directly with -fvisibility=hidden
+# The logic of the Ways prints, so its time would hide the cost of the call.
+#
+# Usage: Tools/SharedLibraryBenchmark.sh [WayDirectory...]    (Way4 and Way99 by default)
+
+set -euo pipefail
+
+TOOLS_DIR=$(cd "$(dirname "$0")" && pwd)
+ROOT_DIR=$(dirname "$TOOLS_DIR")
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2}
+ITERATIONS=${ITERATIONS:-100000000}
+LOAD_RUNS=${LOAD_RUNS:-20}
+
+WAYS=("$@")
+[ ${#WAYS[@]} -eq 0 ] && WAYS=(Way4_ExplicitInstantiations Way99_AliasTemplates)
+
+BUILD_DIR=$(mktemp -d)
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+count_relocations() { readelf -rW "$1" | grep -c ' R_' || true; }
+count_plt_slots() { readelf -rW "$1" | grep -c '_JUMP_SLOT' || true; }
+
+# The best startup time of the loader and its number of relocations
+measure_load() {
+    local best="" relocations="" cycles
+    for ((run = 0; run < LOAD_RUNS; ++run)); do
+        local stats
+        stats=$(LD_DEBUG=statistics "$1" 0 2>&1 >/dev/null)
+        cycles=$(sed -n 's/.*total startup time in dynamic loader: \([0-9]*\) cycles.*/\1/p' <<< "$stats" | head -1)
+        relocations=$(sed -n 's/.*final number of relocations: \([0-9]*\).*/\1/p' <<< "$stats" | head -1)
+        if [ -z "$best" ] || [ "$cycles" -lt "$best" ]; then best=$cycles; fi
+    done
+    echo "$best $relocations"
+}
+
+printf '%-30s %-8s %10s %14s %15s %13s %13s %13s %13s\n' \
+    Way Mode LibDynSyms LibRelocs/PLT MainRelocs/PLT LoaderRelocs LoaderCycles ns/MainToLib ns/LibToLib
+
+for WAY in "${WAYS[@]}"; do
+    SOURCE_DIR="$ROOT_DIR/${WAY%/}"
+    OUT="$BUILD_DIR/$(basename "$SOURCE_DIR")"
+    mkdir -p "$OUT"
+
+    UNIT_SOURCES=("$SOURCE_DIR"/TemplateUnit*.cpp "$TOOLS_DIR/SharedLibraryCallTarget.cpp")
+    LOGIC_SOURCES=("$SOURCE_DIR"/Alpha.cpp "$SOURCE_DIR"/Beta.cpp "$SOURCE_DIR"/Gamma.cpp "$TOOLS_DIR/SharedLibraryCallOverhead.cpp")
+
+    for MODE in static default hidden; do
+        MODE_DIR="$OUT/$MODE"
+        mkdir -p "$MODE_DIR"
+
+        case $MODE in
+        static)
+            $CXX $CXXFLAGS -I"$SOURCE_DIR" "${UNIT_SOURCES[@]}" "${LOGIC_SOURCES[@]}" -o "$MODE_DIR/main"
+            ;;
+        default)
+            $CXX $CXXFLAGS -fPIC -shared -I"$SOURCE_DIR" "${UNIT_SOURCES[@]}" -o "$MODE_DIR/libTemplateUnit.so"
+            ;;
+        hidden)
+            $CXX $CXXFLAGS -fPIC -shared -fvisibility=hidden -include "$TOOLS_DIR/SharedLibraryExport.hpp" -I"$SOURCE_DIR" \
+                "${UNIT_SOURCES[@]}" -o "$MODE_DIR/libTemplateUnit.so"
+            ;;
+        esac
+
+        LIB_SYMS="-"; LIB_RELOCS="-"
+        if [ "$MODE" != static ]; then
+            $CXX $CXXFLAGS -I"$SOURCE_DIR" "${LOGIC_SOURCES[@]}" -L"$MODE_DIR" -lTemplateUnit -Wl,-rpath,'$ORIGIN' -o "$MODE_DIR/main"
+            LIB_SYMS=$(nm -D --defined-only "$MODE_DIR/libTemplateUnit.so" | wc -l)
+            LIB_RELOCS="$(count_relocations "$MODE_DIR/libTemplateUnit.so")/$(count_plt_slots "$MODE_DIR/libTemplateUnit.so")"
+        fi
+
+        read -r LOADER_CYCLES LOADER_RELOCS <<< "$(measure_load "$MODE_DIR/main")"
+        read -r NS_MAIN_TO_LIB NS_LIB_TO_LIB <<< "$("$MODE_DIR/main" "$ITERATIONS" 2>&1 >/dev/null)"
+
+        printf '%-30s %-8s %10s %14s %15s %13s %13s %13s %13s\n' \
+            "$(basename "$SOURCE_DIR")" "$MODE" "$LIB_SYMS" "$LIB_RELOCS" \
+            "$(count_relocations "$MODE_DIR/main")/$(count_plt_slots "$MODE_DIR/main")" \
+            "$LOADER_RELOCS" "$LOADER_CYCLES" "$NS_MAIN_TO_LIB" "$NS_LIB_TO_LIB"
+    done
+done
@@ -0,0 +1,35 @@
+#include "SharedLibraryCallTarget.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Replaces main.cpp of a Way: calls an instantiation, which does nothing, from main and from inside of the library
+// The logic of Alpha, Beta and Gamma is only linked in, so main has the relocations of the Way
+// The best time of one call in ns of several runs goes to stderr: main->library, then library->library
+int main(int argc, char** argv) {
+    const long iterations = argc > 1 ? std::atol(argv[1]) : 100000000;
+    constexpr int runs = 5;
+
+    double best_from_main = 0.0;
+    double best_inside_library = 0.0;
+
+    for (int run = 0; run < runs; ++run) {
+        TemplateClass<int> target;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < iterations; ++i) {
+            target.ComplexTemplateFunc(i);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        const double from_main = iterations > 0 ? elapsed.count() / iterations : 0.0;
+        const double inside_library = TimeCallsInsideLibrary(iterations);
+
+        best_from_main = run == 0 ? from_main : std::min(best_from_main, from_main);
+        best_inside_library = run == 0 ? inside_library : std::min(best_inside_library, inside_library);
+    }
+
+    std::fprintf(stderr, "%.3f %.3f\n", best_from_main, best_inside_library);
+}
@@ -0,0 +1,29 @@
+#include "SharedLibraryCallTarget.hpp"
+
+#include <chrono>
+
+// Neither inlined nor removed: the empty asm only takes the value
+template <>
+template <>
+__attribute__((noinline)) void TemplateClass<int>::ComplexTemplateFunc<long>(const long& value) {
+    __asm__ volatile("" : : "r"(value) : "memory");
+}
+
+// Internal to the library: not declared in the header, so main can not call it
+template <>
+template <>
+__attribute__((noinline)) void TemplateClass<int>::ComplexTemplateFunc<unsigned long>(const unsigned long& value) {
+    __asm__ volatile("" : : "r"(value) : "memory");
+}
+
+double TimeCallsInsideLibrary(long iterations) {
+    TemplateClass<int> target;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        target.ComplexTemplateFunc(static_cast<unsigned long>(i));
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return iterations > 0 ? elapsed.count() / iterations : 0.0;
+}
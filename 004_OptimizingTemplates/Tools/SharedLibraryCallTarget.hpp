@@ -0,0 +1,11 @@
+#pragma once
+
+#include "TemplateUnit.hpp"
+
+// Calls, which do nothing but being calls: the logic of the Ways prints, so its time hides the cost of the call itself.
+// The target of main is exported in every mode, just like the instantiations of the Way.
+template <> template <> __attribute__((visibility("default"))) void TemplateClass<int>::ComplexTemplateFunc<long>(const long& value);
+
+// Calls an instantiation, which only the library uses, from inside of the library, returns the time of one call in ns
+// It is exported and called through the PLT with default visibility, hidden and called directly with -fvisibility=hidden
+__attribute__((visibility("default"))) double TimeCallsInsideLibrary(long iterations);
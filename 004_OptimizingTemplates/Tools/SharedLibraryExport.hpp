@@ -0,0 +1,13 @@
+#pragma once
+
+// Forced into the library TUs (-include), when they are compiled with -fvisibility=hidden.
+// Only the explicit instantiations of the template unit and the non-template SimpleClass stay in the dynamic symbol table,
+// any other instantiation, e.g. the internal call target of SharedLibraryCallTarget.cpp, is hidden.
+// GCC takes the attribute from these redeclarations for the explicit instantiation definitions of the Way.
+struct __attribute__((visibility("default"))) SimpleClass;
+
+#include "TemplateUnit.hpp"
+
+extern template __attribute__((visibility("default"))) void SimpleClass::SimpleTemplateFunc<int>(const int&);
+extern template __attribute__((visibility("default"))) void TemplateClass<int>::EasyFunc();
+extern template __attribute__((visibility("default"))) void TemplateClass<int>::ComplexTemplateFunc<int>(const int&);